@@ -0,0 +1,63 @@
+#include "CacheMissCounter.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+CacheMissCounter::CacheMissCounter()
+{
+#if defined(__linux__)
+    perf_event_attr attributes{};
+    attributes.size = sizeof(attributes);
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+    attributes.disabled = 1;
+    attributes.inherit = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+
+    // this process, any cpu, no group
+    m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+#endif
+}
+
+CacheMissCounter::~CacheMissCounter()
+{
+#if defined(__linux__)
+    if (m_fd >= 0)
+        close(m_fd);
+#endif
+}
+
+bool CacheMissCounter::isAvailable() const { return m_fd >= 0; }
+
+void CacheMissCounter::start()
+{
+#if defined(__linux__)
+    if (m_fd < 0)
+        return;
+
+    ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+std::uint64_t CacheMissCounter::stop()
+{
+    std::uint64_t misses{0};
+
+#if defined(__linux__)
+    if (m_fd < 0)
+        return misses;
+
+    ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    if (read(m_fd, &misses, sizeof(misses)) != static_cast<ssize_t>(sizeof(misses)))
+        misses = 0;
+#endif
+
+    return misses;
+}
@@ -0,0 +1,32 @@
+#include <cstdint> // for std::uint64_t
+
+#ifndef CACHE_MISS_COUNTER_H
+#define CACHE_MISS_COUNTER_H
+
+// counts the hardware cache misses of this process
+// (and every thread it starts after the counter)
+// using the linux perf events interface.
+// on other systems, in containers and when perf events are
+// locked down (kernel.perf_event_paranoid) it's simply unavailable.
+class CacheMissCounter
+{
+public:
+    CacheMissCounter();
+    ~CacheMissCounter();
+
+    CacheMissCounter(const CacheMissCounter &) = delete;
+    CacheMissCounter &operator=(const CacheMissCounter &) = delete;
+
+    bool isAvailable() const;
+
+    // zero the counter and start counting
+    void start();
+
+    // stop counting and return the misses since start()
+    std::uint64_t stop();
+
+private:
+    int m_fd{-1};
+};
+
+#endif
@@ -0,0 +1,301 @@
+#include "WorldBench.h"
+#include "MappedFile.h"
+#include <cmath>        // for std::sqrt
+#include <algorithm>    // for std::max, std::min, std::fill
+#include <span>         // for std::span
+#include <fstream>      // for std::ofstream
+#include <filesystem>   // for std::filesystem::temp_directory_path, std::filesystem::remove
+#include <system_error> // for std::error_code
+
+namespace
+{
+    // ticks between the first and the last launch
+    // of the synthetic missiles
+    constexpr std::uint32_t launchSpread{100};
+}
+
+WorldBench::WorldBench(Case benchCase, std::size_t entities, JobSystem *jobs)
+    : m_case{benchCase},
+      m_entities{entities},
+      m_world{makeConfig(benchCase, entities)}
+{
+    m_world.setJobSystem(jobs);
+
+    switch (m_case)
+    {
+    case Case::updateMissiles:
+        addMissiles(entities);
+        break;
+
+    case Case::updateExplosions:
+        addExplosions(entities);
+        break;
+
+    case Case::applyCollisions:
+        // one explosion for every four missiles,
+        // roughly what a busy game looks like
+        addMissiles(entities);
+        addExplosions(std::max<std::size_t>(1, entities / 4));
+        m_world.updateMissiles();
+        break;
+
+    case Case::placeBuildings:
+        break;
+
+    case Case::skylineLookup:
+    {
+        m_points.reserve(entities);
+
+        for (std::size_t point{0}; point < entities; ++point)
+            m_points.push_back(Vector2{m_rng.getFloat(0.0f, m_world.m_width), m_rng.getFloat(0.0f, m_world.m_height)});
+
+        break;
+    }
+
+    case Case::saveState:
+    case Case::restoreState:
+        // the same busy world as applyCollisions
+        addMissiles(entities);
+        addExplosions(std::max<std::size_t>(1, entities / 4));
+        m_world.saveState(m_state);
+        break;
+
+    case Case::autoDefense:
+        // every missile is a threat the batteries can solve for
+        addEnemyMissiles(entities);
+        break;
+
+    case Case::drawList:
+        addMissiles(entities);
+        addExplosions(std::max<std::size_t>(1, entities / 4));
+        m_world.updateMissiles();
+        m_world.fillSnapshot(m_snapshot);
+        break;
+
+    case Case::cityLayer:
+    {
+        // a screen full of buildings, whatever the world's size
+        const auto width{static_cast<float>(m_cityLayer.getWidth())};
+        const auto height{static_cast<float>(m_cityLayer.getHeight())};
+
+        m_snapshot.buildings.reserve(entities);
+
+        for (std::size_t building{0}; building < entities; ++building)
+        {
+            const float size{m_rng.getFloat(8.0f, 40.0f)};
+
+            m_snapshot.buildings.push_back(RenderSnapshot::BuildingView{
+                Rectangle{m_rng.getFloat(0.0f, width - size), m_rng.getFloat(height / 2.0f, height - size), size, size},
+                building % 2 ? GRAY : DARKGRAY});
+        }
+
+        m_cityLayer.update(m_snapshot.buildings, m_buildingsVersion);
+        m_cityLayer.clearDirty();
+        break;
+    }
+
+    case Case::chainReaction:
+        // applyCollisions with an explosion for every missile,
+        // the screen of a chain reaction in full swing
+        addMissiles(entities);
+        addExplosions(entities);
+        m_world.updateMissiles();
+        break;
+
+    case Case::loadScenario:
+    {
+        // a city of as many buildings along the ground
+        // of the world, and a wave script as long
+        ScenarioBuilder builder{};
+        builder.addLaunchSite(ScenarioFormat::LaunchSite{0.0f, m_world.m_width, 0.0f});
+
+        for (std::size_t building{0}; building < entities; ++building)
+        {
+            const float size{m_rng.getFloat(8.0f, 40.0f)};
+
+            builder.addBuilding(ScenarioFormat::Building{m_rng.getFloat(0.0f, m_world.m_width - size),
+                                                         m_world.m_height - size,
+                                                         size, size, {GRAY.r, GRAY.g, GRAY.b, GRAY.a}});
+
+            builder.addWave(ScenarioFormat::Wave{2.0f, 10, 0.5f, 1, ScenarioFormat::waitForClearSky});
+        }
+
+        std::vector<std::uint8_t> bytes{};
+        builder.write(bytes);
+
+        m_scenarioPath = (std::filesystem::temp_directory_path() / ("missile_commander_bench_" + std::to_string(entities) + ".mcs")).string();
+
+        std::ofstream file{m_scenarioPath, std::ios::binary};
+        file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        break;
+    }
+
+    case Case::maxCases:
+        break;
+    }
+}
+
+WorldBench::~WorldBench()
+{
+    if (!m_scenarioPath.empty())
+    {
+        std::error_code error{};
+        std::filesystem::remove(m_scenarioPath, error);
+    }
+}
+
+void WorldBench::run()
+{
+    switch (m_case)
+    {
+    case Case::updateMissiles:
+        ++m_world.m_tick;
+        m_world.updateMissiles();
+        break;
+
+    case Case::updateExplosions:
+        m_world.updateExplosions();
+        m_world.m_commands.clear();
+        break;
+
+    case Case::applyCollisions:
+    case Case::chainReaction:
+        m_world.applyCollisions();
+        m_world.m_commands.clear();
+        break;
+
+    case Case::placeBuildings:
+        m_world.m_buildings.clear();
+        m_world.m_skyline.clear();
+        m_world.placeBuildings(static_cast<int>(m_entities), 40.0f, 40.0f, GRAY, m_world.m_width, 0.0f, 0.0f);
+        break;
+
+    case Case::skylineLookup:
+        for (const Vector2 &point : m_points)
+            m_hits += m_world.m_skyline.getBuildingAt(point).isValid();
+        break;
+
+    case Case::saveState:
+        m_world.saveState(m_state);
+        break;
+
+    case Case::restoreState:
+        m_hits += m_world.restoreState(m_state);
+        break;
+
+    case Case::autoDefense:
+        // every battery reloaded and no threat engaged,
+        // so every run solves the whole batch again
+        std::fill(m_world.m_batteryReadyTicks.begin(), m_world.m_batteryReadyTicks.end(), 0);
+        std::fill(m_world.m_engagements.begin(), m_world.m_engagements.end(), World::Engagement{});
+        m_world.autoDefend();
+        m_world.m_commands.clear();
+        m_world.m_pendingEngagements.clear();
+        break;
+
+    case Case::drawList:
+        m_drawList.clear();
+        m_drawList.addSnapshot(m_snapshot, 0.5f);
+        m_drawList.submit(m_drawCounter);
+        m_hits += m_drawCounter.getBatches();
+        break;
+
+    case Case::cityLayer:
+    {
+        // every other run the last building is gone
+        const std::span<const RenderSnapshot::BuildingView> buildings{m_snapshot.buildings};
+
+        ++m_buildingsVersion;
+        m_hits += m_cityLayer.update(buildings.first(buildings.size() - m_buildingsVersion % 2), m_buildingsVersion);
+        m_cityLayer.clearDirty();
+        break;
+    }
+
+    case Case::loadScenario:
+    {
+        // map it, check it and stand its city up
+        const MappedFile file{m_scenarioPath};
+        const ScenarioView scenario{file.getBytes(), m_world.m_width, m_world.m_height};
+
+        m_world.m_buildings.clear();
+        m_world.m_skyline.clear();
+        m_world.setupScenarioBuildings(scenario.getBuildings());
+
+        m_hits += scenario.getWaves().size();
+        break;
+    }
+
+    case Case::maxCases:
+        break;
+    }
+}
+
+std::size_t WorldBench::getEntities() const { return m_entities; }
+
+WorldConfig WorldBench::makeConfig(Case benchCase, std::size_t entities)
+{
+    // the demo screen holds about a thousand entities
+    // comfortably, bigger worlds grow in both directions
+    const float scale{std::max(1.0f, std::sqrt(static_cast<float>(entities) / 1000.0f))};
+
+    WorldConfig config{};
+    config.width = 800.0f * scale;
+    config.height = 450.0f * scale;
+    config.seed = 1;
+    config.maxMissiles = entities + 16;
+    config.maxExplosions = entities + 16;
+    config.maxBuildings = entities + 64;
+
+    // sized so the whole batch is solved on every battery
+    config.autoDefense.enabled = benchCase == Case::autoDefense;
+    config.autoDefense.batteries = 4;
+    config.autoDefense.solveBudget = static_cast<int>(std::min<std::size_t>(entities * 4, 1u << 30));
+
+    return config;
+}
+
+void WorldBench::addMissiles(std::size_t count)
+{
+    for (std::size_t missile{0}; missile < count; ++missile)
+    {
+        // half player missiles flying at a random
+        // point, half enemy missiles falling down
+        Missile newMissile{};
+
+        if (missile % 2)
+            m_world.setupPlayerMissile(newMissile, m_world.getLauncherPosition(), Vector2{m_rng.getFloat(0.0f, m_world.m_width), m_rng.getFloat(0.0f, m_world.m_height)});
+        else
+            m_world.setupEnemyMissile(newMissile);
+
+        m_world.getMissiles(newMissile.getFaction()).push(newMissile, m_rng.nextBounded(launchSpread));
+    }
+
+    // every missile is in flight
+    m_world.m_tick = launchSpread;
+}
+
+void WorldBench::addEnemyMissiles(std::size_t count)
+{
+    for (std::size_t missile{0}; missile < count; ++missile)
+    {
+        Missile newMissile{};
+        m_world.setupEnemyMissile(newMissile);
+
+        m_world.getMissiles(newMissile.getFaction()).push(newMissile, m_rng.nextBounded(launchSpread));
+    }
+
+    m_world.m_tick = launchSpread;
+}
+
+void WorldBench::addExplosions(std::size_t count)
+{
+    for (std::size_t explosion{0}; explosion < count; ++explosion)
+    {
+        // grow stays 0 so the explosions keep their size
+        // and every run does the same amount of work
+        Explosion newExplosion{Vector2{m_rng.getFloat(0.0f, m_world.m_width), m_rng.getFloat(0.0f, m_world.m_height)}, m_rng.getFloat(5.0f, 20.0f)};
+        newExplosion.setGrow(0.0f);
+
+        m_world.m_explosions.spawn(newExplosion);
+    }
+}
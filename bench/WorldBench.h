@@ -0,0 +1,110 @@
+#include "World.h"
+#include "JobSystem.h"
+#include "Random.h"
+#include "RenderSnapshot.h"
+#include "DrawList.h"
+#include "CityLayer.h"
+#include "Scenario.h"
+#include <raylib.h>
+#include <array>       // for std::array
+#include <vector>      // for std::vector
+#include <string_view> // for std::string_view
+#include <string>      // for std::string
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint64_t
+
+#ifndef WORLD_BENCH_H
+#define WORLD_BENCH_H
+
+// one hot path of the simulation run on a synthetic
+// world of a given number of entities.
+// the world is sized with the entity count so the
+// density (and with it the work per entity) stays
+// about the same from 10^2 to 10^6 entities.
+// World declares this class a friend so the phases
+// of step() can be timed one by one.
+class WorldBench
+{
+public:
+    enum class Case
+    {
+        updateMissiles,
+        updateExplosions,
+        applyCollisions,
+        placeBuildings,
+        skylineLookup,
+        saveState,
+        restoreState,
+        autoDefense,
+        drawList,
+        cityLayer,
+        chainReaction,
+        loadScenario,
+        maxCases,
+    };
+
+    static constexpr std::array<std::string_view, static_cast<std::size_t>(Case::maxCases)> caseNames{
+        "updateMissiles",
+        "updateExplosions",
+        "applyCollisions",
+        "placeBuildings",
+        "skylineLookup",
+        "saveState",
+        "restoreState",
+        "autoDefense",
+        "drawList",
+        "cityLayer",
+        "chainReaction",
+        "loadScenario",
+    };
+
+    // jobs may be nullptr to run everything on this thread
+    WorldBench(Case benchCase, std::size_t entities, JobSystem *jobs);
+
+    // removes the scenario file of loadScenario
+    ~WorldBench();
+
+    WorldBench(const WorldBench &) = delete;
+    WorldBench &operator=(const WorldBench &) = delete;
+
+    // run the case once over every entity
+    void run();
+
+    std::size_t getEntities() const;
+
+private:
+    static WorldConfig makeConfig(Case benchCase, std::size_t entities);
+
+    void addMissiles(std::size_t count);
+    void addEnemyMissiles(std::size_t count);
+    void addExplosions(std::size_t count);
+
+    Case m_case{};
+    std::size_t m_entities{};
+    World m_world;
+    Random::Pcg32 m_rng{1};
+
+    // the points looked up by skylineLookup
+    std::vector<Vector2> m_points{};
+
+    // what drawList records, sorts and counts the draws of
+    RenderSnapshot m_snapshot{};
+    DrawList m_drawList{};
+    NullDrawBackend m_drawCounter{};
+
+    // what cityLayer knocks a building out of and
+    // puts it back in again, run after run
+    CityLayer m_cityLayer{1920, 1080, RAYWHITE};
+    std::uint64_t m_buildingsVersion{};
+
+    // what saveState writes and restoreState reads back
+    std::vector<std::uint8_t> m_state{};
+
+    // the compiled scenario loadScenario maps, run after run
+    std::string m_scenarioPath{};
+
+    // keeps the compiler from dropping lookups nobody reads
+    std::uint64_t m_hits{};
+};
+
+#endif
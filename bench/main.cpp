@@ -0,0 +1,418 @@
+#include "WorldBench.h"
+#include "CacheMissCounter.h"
+#include "JobSystem.h"
+#include <atomic>      // for std::atomic
+#include <chrono>      // for std::chrono::steady_clock
+#include <vector>      // for std::vector
+#include <string>      // for std::string, std::getline
+#include <string_view> // for std::string_view
+#include <fstream>     // for std::ifstream, std::ofstream
+#include <iostream>    // for std::cout, std::cerr
+#include <charconv>    // for std::from_chars
+#include <algorithm>   // for std::sort, std::clamp
+#include <cmath>       // for std::isfinite
+#include <memory>      // for std::unique_ptr
+#include <new>         // for std::bad_alloc, std::align_val_t
+#include <cstdlib>     // for std::malloc, std::free, std::aligned_alloc
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint64_t
+
+// every allocation of the process goes through here
+// so a case that allocates in steady state shows up
+namespace
+{
+    std::atomic<std::uint64_t> g_allocations{0};
+
+    void *allocate(std::size_t size, std::size_t alignment)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+
+        // aligned_alloc wants the size to be a multiple of the alignment
+        void *memory{alignment > alignof(std::max_align_t)
+                         ? std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)
+                         : std::malloc(size ? size : 1)};
+
+        if (!memory)
+            throw std::bad_alloc{};
+
+        return memory;
+    }
+}
+
+void *operator new(std::size_t size) { return allocate(size, alignof(std::max_align_t)); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return allocate(size, static_cast<std::size_t>(alignment)); }
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+namespace
+{
+    struct Result
+    {
+        std::string name{};
+        std::size_t entities{};
+        double nsPerEntity{};
+        double allocationsPerRun{};
+
+        // negative when the counter isn't available
+        double cacheMissesPerEntity{-1.0};
+    };
+
+    struct Options
+    {
+        std::size_t maxEntities{1'000'000};
+        int samples{5};
+
+        // how long one sample runs for at least
+        double sampleSeconds{0.02};
+
+        unsigned jobs{0};
+        bool useJobs{false};
+
+        std::string outPath{};
+        std::string baselinePath{};
+
+        // a case is a regression once it's this much slower
+        double threshold{0.10};
+    };
+
+    // the whole word has to be the number
+    template <typename T>
+    bool parseNumber(std::string_view word, T &value)
+    {
+        const auto [end, error]{std::from_chars(word.data(), word.data() + word.size(), value)};
+        return error == std::errc{} && end == word.data() + word.size();
+    }
+
+    bool parseOptions(int argc, char *argv[], Options &options)
+    {
+        // the biggest world measured is the last
+        // power of ten up to --max-entities
+        constexpr std::size_t maxEntities{100'000'000};
+
+        for (int arg{1}; arg < argc; ++arg)
+        {
+            const std::string_view name{argv[arg]};
+
+            // every option takes a value
+            if (arg + 1 == argc)
+            {
+                std::cerr << name << " wants a value\n";
+                return false;
+            }
+
+            const std::string_view value{argv[++arg]};
+
+            bool parsed{};
+            std::string_view wanted{};
+
+            if (name == "--max-entities")
+            {
+                parsed = parseNumber(value, options.maxEntities) && options.maxEntities >= 100 && options.maxEntities <= maxEntities;
+                wanted = "a number of entities from 100 to 100000000";
+            }
+            else if (name == "--samples")
+            {
+                parsed = parseNumber(value, options.samples) && options.samples > 0;
+                wanted = "a whole number above 0";
+            }
+            else if (name == "--sample-seconds")
+            {
+                parsed = parseNumber(value, options.sampleSeconds) && std::isfinite(options.sampleSeconds) && options.sampleSeconds > 0.0;
+                wanted = "a number of seconds above 0";
+            }
+            else if (name == "--jobs")
+            {
+                parsed = parseNumber(value, options.jobs) && options.jobs <= JobSystem::maxWorkerCount;
+                wanted = "a number of workers from 0 (one per spare core) to 1024";
+                options.useJobs = true;
+            }
+            else if (name == "--out")
+            {
+                options.outPath = value;
+                parsed = !value.empty();
+                wanted = "a file to write";
+            }
+            else if (name == "--baseline")
+            {
+                options.baselinePath = value;
+                parsed = !value.empty();
+                wanted = "a file written by --out";
+            }
+            else if (name == "--threshold")
+            {
+                parsed = parseNumber(value, options.threshold) && std::isfinite(options.threshold) && options.threshold >= 0.0;
+                wanted = "a fraction of 0 or more, 0.1 for 10%";
+            }
+            else
+            {
+                std::cerr << "unknown option " << name << '\n';
+                return false;
+            }
+
+            if (!parsed)
+            {
+                std::cerr << name << " wants " << wanted << ", not \"" << value << "\"\n";
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    double getSeconds(std::chrono::steady_clock::time_point from)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - from).count();
+    }
+
+    Result measure(WorldBench::Case benchCase, std::size_t entities, const Options &options, JobSystem *jobs, CacheMissCounter &cacheMisses)
+    {
+        WorldBench bench{benchCase, entities, jobs};
+
+        // the first run grows every buffer to its final size
+        const auto warmUpStart{std::chrono::steady_clock::now()};
+        bench.run();
+        const double runSeconds{std::max(getSeconds(warmUpStart), 1e-9)};
+
+        const auto runs{static_cast<std::uint64_t>(std::clamp(options.sampleSeconds / runSeconds, 1.0, 1e6))};
+
+        std::vector<double> nsPerEntity{};
+        std::uint64_t allocations{0};
+        std::uint64_t misses{0};
+
+        for (int sample{0}; sample < options.samples; ++sample)
+        {
+            const std::uint64_t allocationsBefore{g_allocations.load(std::memory_order_relaxed)};
+            cacheMisses.start();
+            const auto start{std::chrono::steady_clock::now()};
+
+            for (std::uint64_t run{0}; run < runs; ++run)
+                bench.run();
+
+            const double seconds{getSeconds(start)};
+            misses += cacheMisses.stop();
+            allocations += g_allocations.load(std::memory_order_relaxed) - allocationsBefore;
+
+            nsPerEntity.push_back(seconds * 1e9 / static_cast<double>(runs * entities));
+        }
+
+        // the median sample, one slow sample
+        // (a context switch, ...) doesn't count
+        std::sort(nsPerEntity.begin(), nsPerEntity.end());
+
+        const double totalRuns{static_cast<double>(runs) * options.samples};
+
+        Result result{};
+        result.name = WorldBench::caseNames[static_cast<std::size_t>(benchCase)];
+        result.entities = entities;
+        result.nsPerEntity = nsPerEntity[nsPerEntity.size() / 2];
+        result.allocationsPerRun = static_cast<double>(allocations) / totalRuns;
+
+        if (cacheMisses.isAvailable())
+            result.cacheMissesPerEntity = static_cast<double>(misses) / (totalRuns * static_cast<double>(entities));
+
+        return result;
+    }
+
+    // one result per line, so the baseline can be
+    // read back without a real json parser
+    void writeJson(std::ostream &out, const std::vector<Result> &results, unsigned threads)
+    {
+        out << "{\n  \"threads\": " << threads << ",\n  \"results\": [\n";
+
+        for (std::size_t i{0}; i < results.size(); ++i)
+        {
+            const Result &result{results[i]};
+
+            out << "    {\"name\": \"" << result.name
+                << "\", \"entities\": " << result.entities
+                << ", \"nsPerEntity\": " << result.nsPerEntity
+                << ", \"allocationsPerRun\": " << result.allocationsPerRun
+                << ", \"cacheMissesPerEntity\": ";
+
+            if (result.cacheMissesPerEntity < 0.0)
+                out << "null";
+            else
+                out << result.cacheMissesPerEntity;
+
+            out << (i + 1 < results.size() ? "},\n" : "}\n");
+        }
+
+        out << "  ]\n}\n";
+    }
+
+    // the text right after "key": on line
+    std::string_view findValue(std::string_view line, std::string_view key)
+    {
+        const std::string quoted{'"' + std::string{key} + "\": "};
+        const std::size_t start{line.find(quoted)};
+
+        if (start == std::string_view::npos)
+            return {};
+
+        std::string_view value{line.substr(start + quoted.size())};
+        value = value.substr(0, value.find_first_of(",}"));
+
+        if (value.size() >= 2 && value.front() == '"')
+            value = value.substr(1, value.size() - 2);
+
+        return value;
+    }
+
+    // false, and why on std::cerr, if the file can't be
+    // read or a line of it isn't one --out writes
+    bool readBaseline(const std::string &path, std::vector<Result> &results)
+    {
+        std::ifstream in{path};
+
+        if (!in)
+        {
+            std::cerr << "can't open baseline " << path << '\n';
+            return false;
+        }
+
+        int lineNumber{0};
+
+        for (std::string line{}; std::getline(in, line);)
+        {
+            ++lineNumber;
+
+            const std::string_view name{findValue(line, "name")};
+
+            if (name.empty())
+                continue;
+
+            Result result{};
+            result.name = name;
+
+            // the comparison divides by nsPerEntity
+            if (!parseNumber(findValue(line, "entities"), result.entities) ||
+                !parseNumber(findValue(line, "nsPerEntity"), result.nsPerEntity) ||
+                !std::isfinite(result.nsPerEntity) || result.nsPerEntity <= 0.0)
+            {
+                std::cerr << path << ':' << lineNumber << ": entities wants a whole number and nsPerEntity one above 0\n";
+                return false;
+            }
+
+            results.push_back(result);
+        }
+
+        if (results.empty())
+        {
+            std::cerr << "no results in baseline " << path << '\n';
+            return false;
+        }
+
+        return true;
+    }
+
+    // prints every case slower than the baseline by more than
+    // the threshold and returns how many there were
+    int compareWithBaseline(const std::vector<Result> &results, const std::vector<Result> &baseline, double threshold)
+    {
+        int regressions{0};
+
+        for (const Result &result : results)
+        {
+            for (const Result &base : baseline)
+            {
+                if (base.name != result.name || base.entities != result.entities)
+                    continue;
+
+                const double change{result.nsPerEntity / base.nsPerEntity - 1.0};
+
+                if (change > threshold)
+                {
+                    std::cerr << "REGRESSION " << result.name << " @ " << result.entities
+                              << ": " << base.nsPerEntity << " -> " << result.nsPerEntity
+                              << " ns/entity (+" << change * 100.0 << "%)\n";
+                    ++regressions;
+                }
+            }
+        }
+
+        return regressions;
+    }
+}
+
+// bench [--max-entities n] [--samples n] [--sample-seconds s] [--jobs n]
+//       [--out results.json] [--baseline baseline.json] [--threshold 0.1]
+// runs every case on worlds of 10^2 .. 10^6 entities and writes
+// json to --out (or stdout). with --baseline it exits with 1
+// if any case got slower than the baseline by more than --threshold
+int main(int argc, char *argv[])
+{
+    Options options{};
+
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    // both files are checked before minutes of measuring
+    std::vector<Result> baseline{};
+
+    if (!options.baselinePath.empty() && !readBaseline(options.baselinePath, baseline))
+        return 1;
+
+    std::ofstream out{};
+
+    if (!options.outPath.empty())
+    {
+        out.open(options.outPath);
+
+        if (!out)
+        {
+            std::cerr << "can't write " << options.outPath << '\n';
+            return 1;
+        }
+    }
+
+    // opened before the job system so its
+    // worker threads are counted too
+    CacheMissCounter cacheMisses{};
+
+    if (!cacheMisses.isAvailable())
+        std::cerr << "cache misses unavailable (no perf events), reported as null\n";
+
+    // --jobs 0 means one worker per spare core
+    std::unique_ptr<JobSystem> jobs{};
+
+    if (options.useJobs)
+        jobs = std::make_unique<JobSystem>(options.jobs);
+
+    std::vector<Result> results{};
+
+    for (std::size_t benchCase{0}; benchCase < WorldBench::caseNames.size(); ++benchCase)
+    {
+        for (std::size_t entities{100}; entities <= options.maxEntities; entities *= 10)
+        {
+            results.push_back(measure(static_cast<WorldBench::Case>(benchCase), entities, options, jobs.get(), cacheMisses));
+
+            const Result &result{results.back()};
+            std::cerr << result.name << " @ " << result.entities << ": "
+                      << result.nsPerEntity << " ns/entity, "
+                      << result.allocationsPerRun << " allocations/run\n";
+        }
+    }
+
+    const unsigned threads{jobs ? jobs->getThreadCount() : 1};
+
+    if (options.outPath.empty())
+        writeJson(std::cout, results, threads);
+    else
+    {
+        writeJson(out, results, threads);
+        out.close();
+
+        if (!out)
+        {
+            std::cerr << "couldn't write all of " << options.outPath << '\n';
+            return 1;
+        }
+    }
+
+    if (baseline.empty())
+        return 0;
+
+    return compareWithBaseline(results, baseline, options.threshold) > 0 ? 1 : 0;
+}
@@ -0,0 +1,78 @@
+#include <vector>  // for std::vector
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint32_t, std::uint64_t
+
+#ifndef ALLOCATION_TRACKER_H
+#define ALLOCATION_TRACKER_H
+
+// counts every heap allocation of the process by the phase
+// (the innermost PROFILE_SCOPE() of the thread) it happened in.
+// the counting itself is done by the global operator new and
+// delete of src/AllocationHooks.cpp, which only replaces them
+// when built with MISSILE_COMMANDER_TRACK_ALLOCATIONS (cmake
+// option of the same name). without it nothing is counted and
+// every PROFILE_SCOPE() is as cheap as before.
+// allocations outside of any scope are counted as "other",
+// so are the ones made by jobs on worker threads.
+namespace AllocationTracker
+{
+    struct PhaseStats
+    {
+        const char *name{};
+
+        std::uint64_t allocations{};
+        std::uint64_t frees{};
+        std::uint64_t bytes{};
+
+        // what the phase allocated and hasn't been freed yet,
+        // and the most that ever was
+        std::uint64_t liveBytes{};
+        std::uint64_t peakBytes{};
+    };
+
+    // the hooks are linked in, so the numbers mean something
+    bool isEnabled();
+
+    // the phase of the calling thread, for the hooks
+    // to hand back to recordAllocation()/recordFree()
+    std::uint32_t getPhase();
+
+    // called by the hooks, safe from any thread
+    void recordAllocation(std::uint32_t phase, std::size_t bytes);
+    void recordFree(std::uint32_t phase, std::size_t bytes);
+
+    // every allocation of the process so far
+    std::uint64_t getAllocations();
+
+    // replace stats with the counters of every phase
+    // that has been entered at least once
+    void collect(std::vector<PhaseStats> &stats);
+
+    // the phase the allocations of the calling thread go to,
+    // nested scopes hand it back to the outer one on the way out
+    std::uint32_t enter(const char *name);
+    void leave(std::uint32_t previous);
+}
+
+// counts the allocations of the scope it lives in towards name
+class AllocationScope
+{
+public:
+    explicit AllocationScope(const char *name)
+        : m_previous{AllocationTracker::enter(name)}
+    {
+    }
+
+    ~AllocationScope()
+    {
+        AllocationTracker::leave(m_previous);
+    }
+
+    AllocationScope(const AllocationScope &) = delete;
+    AllocationScope &operator=(const AllocationScope &) = delete;
+
+private:
+    std::uint32_t m_previous{};
+};
+
+#endif
@@ -0,0 +1,158 @@
+#include <span>        // for std::span
+#include <vector>      // for std::vector
+#include <array>       // for std::array
+#include <bit>         // for std::bit_cast
+#include <cstddef>     // for std::size_t, std::ptrdiff_t
+#include <cstdint>     // for std::uint8_t, std::uint32_t, std::uint64_t, std::int64_t
+#include <cstring>     // for std::memcpy
+#include <type_traits> // for std::is_trivially_copyable_v
+
+#ifndef BYTE_STREAM_H
+#define BYTE_STREAM_H
+
+// the two halves of every binary format of the game
+// (replays, world snapshots, scenarios).
+// fixed-size values are little-endian, whatever the machine.
+// varints take 7 bits per byte, so small numbers (tick deltas,
+// counts) only cost one byte, and zigzag maps small negative
+// numbers to small unsigned ones before they're varint coded.
+//
+// writeValue() and writeArray() are the exception: they blit the
+// raw bytes of trivially copyable values, in the machine's own
+// byte order. only use them for data that is read back by the
+// same build on the same machine (world snapshots), never for files.
+
+// appends to a byte vector
+class ByteWriter
+{
+public:
+    explicit ByteWriter(std::vector<std::uint8_t> &bytes);
+
+    void writeU8(std::uint8_t value);
+    void writeU32(std::uint32_t value);
+    void writeU64(std::uint64_t value);
+    void writeFloat(float value);
+    void writeVarint(std::uint64_t value);
+    void writeZigzag(std::int64_t value);
+    void writeBytes(std::span<const std::uint8_t> bytes);
+
+    // zeros up to the next multiple of alignment bytes from the
+    // start of the vector (so of the file, if the vector starts it)
+    // for data that is used in place once it's read back
+    void writePadding(std::size_t alignment);
+
+    template <typename T>
+    void writeValue(const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "only plain data can be blitted");
+
+        writeBytes(std::span<const std::uint8_t>{reinterpret_cast<const std::uint8_t *>(&value), sizeof(T)});
+    }
+
+    // the length of values followed by all of its bytes in one go
+    template <typename T>
+    void writeArray(std::span<const T> values)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "only plain data can be blitted");
+
+        writeVarint(values.size());
+        writeBytes(std::span<const std::uint8_t>{reinterpret_cast<const std::uint8_t *>(values.data()), values.size_bytes()});
+    }
+
+private:
+    std::vector<std::uint8_t> &m_bytes;
+};
+
+// reads from a span of bytes
+// reading past the end (or a varint that never ends) doesn't
+// crash, it returns 0 and marks the reader as failed, so a whole
+// record can be read and checked once with hasFailed()
+class ByteReader
+{
+public:
+    explicit ByteReader(std::span<const std::uint8_t> bytes);
+
+    std::uint8_t readU8();
+    std::uint32_t readU32();
+    std::uint64_t readU64();
+    float readFloat();
+    std::uint64_t readVarint();
+    std::int64_t readZigzag();
+
+    // the next count bytes, empty if there aren't that many
+    std::span<const std::uint8_t> readBytes(std::size_t count);
+
+    // skip what writePadding() wrote
+    void skipPadding(std::size_t alignment);
+
+    // T doesn't need a default constructor, the value is
+    // bit_cast straight out of the bytes (all zero on failure)
+    template <typename T>
+    T readValue()
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "only plain data can be blitted");
+
+        std::array<std::uint8_t, sizeof(T)> raw{};
+        const std::span<const std::uint8_t> bytes{readBytes(sizeof(T))};
+
+        if (!bytes.empty())
+            std::memcpy(raw.data(), bytes.data(), sizeof(T));
+
+        return std::bit_cast<T>(raw);
+    }
+
+    // read what writeArray() wrote into values
+    // more than maxSize elements fails the reader instead, so a
+    // broken buffer can't make values outgrow its reserved memory
+    template <typename T>
+    void readArray(std::vector<T> &values, std::size_t maxSize)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "only plain data can be blitted");
+
+        const std::uint64_t count{readVarint()};
+
+        if (count > maxSize || count > getRemaining() / sizeof(T))
+        {
+            m_failed = true;
+            return;
+        }
+
+        const auto size{static_cast<std::size_t>(count)};
+        const std::span<const std::uint8_t> bytes{readBytes(size * sizeof(T))};
+
+        if (m_failed)
+            return;
+
+        // the elements values already has are overwritten in one
+        // go, only the ones it's short of are appended one by one
+        // (T may not have a default constructor to resize() with)
+        if (values.size() > size)
+            values.erase(values.begin() + static_cast<std::ptrdiff_t>(size), values.end());
+
+        const std::size_t kept{values.size()};
+
+        if (kept > 0)
+            std::memcpy(values.data(), bytes.data(), kept * sizeof(T));
+
+        for (std::size_t element{kept}; element < size; ++element)
+        {
+            std::array<std::uint8_t, sizeof(T)> raw{};
+            std::memcpy(raw.data(), bytes.data() + element * sizeof(T), sizeof(T));
+
+            values.push_back(std::bit_cast<T>(raw));
+        }
+    }
+
+    bool hasFailed() const;
+    bool isAtEnd() const;
+
+    std::size_t getPosition() const;
+    std::size_t getRemaining() const;
+
+private:
+    std::span<const std::uint8_t> m_bytes{};
+    std::size_t m_position{};
+    bool m_failed{};
+};
+
+#endif
@@ -0,0 +1,100 @@
+#include "RenderSnapshot.h"
+#include <raylib.h>
+#include <vector>  // for std::vector
+#include <span>    // for std::span
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+
+#ifndef CITY_LAYER_H
+#define CITY_LAYER_H
+
+// a block of whole pixels
+struct PixelRect
+{
+    int x{};
+    int y{};
+    int width{};
+    int height{};
+
+    bool isEmpty() const { return width <= 0 || height <= 0; }
+};
+
+// the background and the buildings, rasterized once into an
+// image on the CPU instead of drawn shape by shape every frame.
+// the buildings only ever change when one is destroyed, so
+// update() is a single compare on almost every frame; when
+// they do change only the pixels under the buildings that
+// came or went are rasterized again, and only those regions
+// are reported dirty for uploading to a texture.
+// there's no GPU in here at all, so it runs headless.
+class CityLayer
+{
+public:
+    CityLayer(int width, int height, const Color &background);
+
+    // bring the pixels up to date with buildings
+    // version is RenderSnapshot::buildingsVersion, nothing is
+    // looked at while it stays the same (except the first time)
+    // returns true if any pixel changed
+    bool update(std::span<const RenderSnapshot::BuildingView> buildings, std::uint64_t version);
+
+    // the regions changed since the last clearDirty()
+    // a region may be reported more than once
+    std::span<const PixelRect> getDirtyRects() const;
+    void clearDirty();
+
+    // the layer as a raylib image (RGBA, 8 bits per channel)
+    // pointing into the layer, it isn't a copy
+    Image getImage();
+
+    // the pixels of region, row after row
+    void copyPixels(const PixelRect &region, std::vector<Color> &pixels) const;
+
+    Color getPixel(int x, int y) const;
+
+    int getWidth() const;
+    int getHeight() const;
+
+    // pixels written since the layer was made,
+    // to see how little an update rasterizes
+    std::uint64_t getRasterizedPixels() const;
+
+private:
+    // the pixels whose centres fall inside rectangle,
+    // clipped to the layer
+    PixelRect toPixels(const Rectangle &rectangle) const;
+
+    // replace the pixels of region with tint
+    void fill(const PixelRect &region, const Color &tint);
+
+    // draw tint over the pixels of region, blended
+    // like the GPU does unless it's opaque
+    void paint(const PixelRect &region, const Color &tint);
+
+    // the background and every building overlapping region
+    void redraw(const PixelRect &region);
+
+    int m_width{};
+    int m_height{};
+    Color m_background{};
+
+    std::vector<Color> m_pixels{};
+
+    // the buildings drawn right now, sorted so two
+    // sets can be compared in one walk
+    std::vector<RenderSnapshot::BuildingView> m_buildings{};
+    std::vector<RenderSnapshot::BuildingView> m_incoming{};
+
+    // the same buildings in snapshot order, the order
+    // they are drawn in
+    std::vector<RenderSnapshot::BuildingView> m_drawOrder{};
+
+    std::vector<PixelRect> m_dirty{};
+
+    std::uint64_t m_version{};
+    bool m_isBuilt{false};
+
+    std::uint64_t m_rasterizedPixels{};
+};
+
+#endif
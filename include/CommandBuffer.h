@@ -0,0 +1,60 @@
+#include "Missile.h"
+#include "Explosion.h"
+#include "SlotMap.h"
+#include <vector>  // for std::vector
+#include <array>   // for std::array
+#include <span>    // for std::span
+#include <cstddef> // for std::size_t
+
+#ifndef COMMAND_BUFFER_H
+#define COMMAND_BUFFER_H
+
+// records every kill and spawn the simulation phases want
+// while they run, so no phase ever erases from a container
+// it is iterating. World applies the whole buffer once
+// at the end of the tick in one batched pass per pool.
+class CommandBuffer
+{
+public:
+    // reserve room for the busiest tick the world's capacities
+    // allow, so recording never allocates: every missile of a
+    // faction can arrive and be hit on the same tick, every
+    // enemy missile can take a building down with it, every
+    // player missile can turn into an explosion and every
+    // faction can fill its store
+    CommandBuffer(std::size_t maxMissiles, std::size_t maxExplosions);
+
+    // the handles of every faction's store are separate,
+    // so a missile is killed in the store of its faction
+    void killMissile(Faction faction, const Handle &missile);
+    void killExplosion(const Handle &explosion);
+    void killBuilding(const Handle &building);
+
+    void spawnMissile(const Missile &missile);
+    void spawnExplosion(const Explosion &explosion);
+
+    // make room for count more missile spawns in one go,
+    // before a burst of them is recorded. only a tick busier
+    // than the constructor made room for ever allocates
+    void reserveMissileSpawns(std::size_t count);
+
+    std::span<const Handle> getMissileKills(Faction faction) const;
+    std::span<const Handle> getExplosionKills() const;
+    std::span<const Handle> getBuildingKills() const;
+
+    std::span<const Missile> getMissileSpawns() const;
+    std::span<const Explosion> getExplosionSpawns() const;
+
+    // forget every recorded command but keep the memory
+    void clear();
+
+private:
+    std::array<std::vector<Handle>, factionCount> m_missileKills{};
+    std::vector<Handle> m_explosionKills{};
+    std::vector<Handle> m_buildingKills{};
+
+    std::vector<Missile> m_missileSpawns{};
+    std::vector<Explosion> m_explosionSpawns{};
+};
+
+#endif
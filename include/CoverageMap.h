@@ -0,0 +1,61 @@
+#include <raylib.h>
+#include <vector>  // for std::vector
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint64_t
+
+#ifndef COVERAGE_MAP_H
+#define COVERAGE_MAP_H
+
+// the playfield as a bitmap of small square cells, one bit
+// per cell, set where a cell lies wholly inside some circle.
+// a point in a set cell is inside that circle for sure, so
+// asking "is this point covered?" is a single bit lookup;
+// a clear bit only means the point needs the exact test.
+// circles are filled a row of cells at a time, 64 cells per
+// word, and clearing keeps the memory and only touches the
+// rows that were filled.
+class CoverageMap
+{
+public:
+    CoverageMap(float width, float height, float cellSize);
+
+    // forget every filled circle
+    void clear();
+
+    // set the bit of every cell that is wholly inside the circle
+    void fillCircle(const Vector2 &center, float radius);
+
+    // the point lies in a cell some circle covers whole
+    // anything outside the map is never covered
+    bool isCovered(const Vector2 &point) const;
+
+    float getCellSize() const;
+
+    std::size_t getColumnCount() const;
+    std::size_t getRowCount() const;
+
+    // how many cells are set, for stats and benchmarks
+    std::size_t getCoveredCells() const;
+
+private:
+    // set the bits of the columns [first, last] of row
+    void fillSpan(std::size_t row, std::size_t first, std::size_t last);
+
+    float m_cellSize{};
+
+    // multiplied with instead of dividing by the cell size
+    float m_cellsPerUnit{};
+
+    std::size_t m_columns{};
+    std::size_t m_rows{};
+    std::size_t m_wordsPerRow{};
+
+    // m_words[row * m_wordsPerRow + column / 64], bit column % 64
+    std::vector<std::uint64_t> m_words{};
+
+    // the rows filled since the last clear(), empty if first > last
+    std::size_t m_firstDirtyRow{};
+    std::size_t m_lastDirtyRow{};
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "RenderSnapshot.h"
+#include <raylib.h>
+#include <vector>  // for std::vector
+#include <array>   // for std::array
+#include <span>    // for std::span
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t, std::uint32_t, std::uint64_t
+
+#ifndef DRAW_LIST_H
+#define DRAW_LIST_H
+
+// the shapes the game draws
+enum class DrawPrimitive : std::uint8_t
+{
+    line,
+    circle,
+    rectangle,
+};
+
+// one shape to draw
+//   line:      from a to b
+//   circle:    centred on a, b.x is the radius
+//   rectangle: top left corner a, size b
+struct DrawCommand
+{
+    Vector2 a{};
+    Vector2 b{};
+    Color tint{};
+    DrawPrimitive primitive{};
+    std::uint8_t layer{};
+};
+
+// a run of commands a backend can draw in one go:
+// the same layer and primitive, sorted by colour
+struct DrawBatch
+{
+    std::uint8_t layer{};
+    DrawPrimitive primitive{};
+    std::uint32_t first{};
+    std::uint32_t count{};
+};
+
+// where a DrawList ends up
+// one call per batch, the commands of the batch are
+// already sorted by colour
+class DrawBackend
+{
+public:
+    DrawBackend() = default;
+    virtual ~DrawBackend() = default;
+
+    DrawBackend(const DrawBackend &) = delete;
+    DrawBackend &operator=(const DrawBackend &) = delete;
+
+    virtual void drawBatch(const DrawBatch &batch, std::span<const DrawCommand> commands) = 0;
+};
+
+// draws nothing, only counts what it would have drawn
+// so draw calls can be checked without a window or a GPU
+class NullDrawBackend : public DrawBackend
+{
+public:
+    void drawBatch(const DrawBatch &batch, std::span<const DrawCommand> commands) override;
+
+    std::uint64_t getBatches() const;
+    std::uint64_t getCommands() const;
+
+    // commands of one primitive
+    std::uint64_t getCommands(DrawPrimitive primitive) const;
+
+    void reset();
+
+private:
+    std::uint64_t m_batches{};
+    std::array<std::uint64_t, 3> m_commands{};
+};
+
+// the draw commands of one frame
+// shapes are recorded in any order, then sorted by layer,
+// primitive and colour so a backend can draw every shape
+// of a kind in one batch instead of one call each.
+// layers are drawn in order, so a later layer always ends up
+// on top; inside a layer the order of the shapes isn't kept.
+// everything is reused from frame to frame, once the buffers
+// have grown big enough recording doesn't allocate.
+class DrawList
+{
+public:
+    // forget the last frame
+    void clear();
+
+    // the layer shapes recorded from now on go on
+    void setLayer(std::uint8_t layer);
+
+    void addLine(const Vector2 &from, const Vector2 &to, const Color &tint);
+    void addCircle(const Vector2 &center, float radius, const Color &tint);
+    void addRectangle(const Rectangle &rectangle, const Color &tint);
+
+    // the missiles and explosions of a snapshot, alpha of
+    // the way from its previous tick to its last one
+    // the buildings hardly ever change, the game draws them
+    // from a CityLayer instead
+    void addSnapshot(const RenderSnapshot &snapshot, float alpha);
+
+    // the buildings of a snapshot as one rectangle each,
+    // between the missiles and the explosions
+    void addBuildings(const RenderSnapshot &snapshot);
+
+    // sort the commands and split them into batches
+    void sort();
+
+    // sort() and hand every batch to backend
+    void submit(DrawBackend &backend);
+
+    std::size_t size() const;
+
+    // valid after sort()
+    std::span<const DrawCommand> getCommands() const;
+    std::span<const DrawBatch> getBatches() const;
+
+private:
+    struct SortKey
+    {
+        std::uint64_t key{};
+        std::uint32_t index{};
+    };
+
+    std::uint8_t m_layer{};
+
+    // in the order they were recorded...
+    std::vector<DrawCommand> m_commands{};
+
+    // ...and in the order they are drawn in
+    std::vector<SortKey> m_keys{};
+    std::vector<DrawCommand> m_sorted{};
+    std::vector<DrawBatch> m_batches{};
+};
+
+#endif
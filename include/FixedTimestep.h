@@ -0,0 +1,40 @@
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+// turns real (frame) time into a whole number of
+// fixed-length simulation ticks.
+// the simulation always moves by the same amount per tick,
+// no matter how fast or slow frames are drawn.
+// whatever time is left over becomes the alpha used to
+// blend the last two ticks when drawing.
+class FixedTimestep
+{
+public:
+    // tickRate is in ticks per second
+    // maxStepsPerFrame stops a slow frame from asking for
+    // more ticks than the machine can run, which would make
+    // the next frame even slower (the "spiral of death")
+    FixedTimestep(double tickRate, int maxStepsPerFrame);
+
+    // add a frame's worth of real time and return how many
+    // ticks should be stepped for it
+    int advance(double frameSeconds);
+
+    // how far between the last tick and the next one
+    // we are, from 0 to 1
+    float getAlpha() const;
+
+    double getTickRate() const;
+    double getTickSeconds() const;
+
+    // ticks thrown away by the maxStepsPerFrame guard so far
+    long long getDroppedTicks() const;
+
+private:
+    double m_tickSeconds{};
+    int m_maxStepsPerFrame{};
+    double m_accumulator{};
+    long long m_droppedTicks{};
+};
+
+#endif
@@ -0,0 +1,26 @@
+#include <raylib.h>
+#include <cstdint> // for std::uint32_t
+
+#ifndef INPUT_FRAME_H
+#define INPUT_FRAME_H
+
+// everything the simulation needs to know
+// from outside for a single tick: the player and,
+// if the waves are scripted, the enemy.
+// the raylib front end fills it from the mouse,
+// a headless driver can fill it from anywhere.
+struct InputFrame
+{
+    // true if the player fired a missile on this tick
+    bool fire{};
+
+    // the position the player's missile should fly to
+    // only meaningful when fire is true
+    Vector2 target{};
+
+    // how many enemy missiles to launch on this tick
+    // on top of the world's own, a WaveDirector decides
+    std::uint32_t enemies{};
+};
+
+#endif
@@ -0,0 +1,82 @@
+#include "MissileStore.h"
+#include <raylib.h>
+#include <vector>  // for std::vector
+#include <span>    // for std::span
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint32_t, std::uint64_t
+
+#ifndef INTERCEPT_SOLVER_H
+#define INTERCEPT_SOLVER_H
+
+// finds where an interceptor fired now meets each of a
+// batch of incoming missiles.
+// both the threat and the interceptor speed up along a
+// quadratic until they reach top speed, so there's no
+// closed form worth having. instead every threat is
+// bisected on (interceptor distance - distance to the
+// threat) over the ticks ahead, 4 (SSE) or 8 (AVX) threats
+// at once, all of them for the same fixed number of steps.
+//
+// the threats are gathered once per tick and solved once
+// per launcher. like MissileStore, the SIMD and scalar
+// paths give bit-identical results, so auto-defense plays
+// the same on every build.
+class InterceptSolver
+{
+public:
+    explicit InterceptSolver(std::size_t capacity);
+
+    // copy the flights of the missiles at indices
+    // out of the store, as seen from tick
+    void gather(const MissileStore &missiles, std::span<const std::uint32_t> indices, std::uint64_t tick);
+
+    std::size_t size() const;
+
+    // for every gathered threat, the (fractional) ticks from
+    // now until an interceptor fired now from launcher has
+    // flown as far as the threat is from it, a tick later.
+    // negative if the threat lands first.
+    // speed and topSpeed are the interceptor's, as in MissileStore.
+    // ahead needs room for size() values
+    void solve(Vector2 launcher, float speed, float topSpeed, std::span<float> ahead) const;
+
+    // same as solve() but one threat at a time
+    void solveScalar(Vector2 launcher, float speed, float topSpeed, std::span<float> ahead) const;
+
+private:
+    // bisection steps, enough to split the longest
+    // flight on screen to well under a tick
+    static constexpr int steps{16};
+
+    struct Launcher
+    {
+        float x{};
+        float y{};
+        float speed{};
+        float rampTicks{};
+        float topSpeed{};
+    };
+
+    void solveScalar(const Launcher &launcher, std::size_t first, std::span<float> ahead) const;
+
+    // the flight of every threat, one array per property
+    // (see MissileStore)
+    std::vector<float> m_startX{};
+    std::vector<float> m_startY{};
+    std::vector<float> m_dirX{};
+    std::vector<float> m_dirY{};
+    std::vector<float> m_length{};
+    std::vector<float> m_speed{};
+    std::vector<float> m_rampTicks{};
+
+    // age a tick from now, when an explosion of a
+    // missile fired now first catches anything
+    std::vector<float> m_age{};
+
+    // the last tick ahead worth intercepting on
+    std::vector<float> m_maxAhead{};
+
+    float m_topSpeed{};
+};
+
+#endif
@@ -0,0 +1,155 @@
+#include <vector>             // for std::vector
+#include <array>              // for std::array
+#include <thread>             // for std::jthread
+#include <mutex>              // for std::mutex
+#include <condition_variable> // for std::condition_variable
+#include <atomic>             // for std::atomic
+#include <algorithm>          // for std::max, std::min
+#include <cstddef>            // for std::size_t
+#include <type_traits>        // for std::remove_reference_t
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+// a small pool of worker threads that split loops between them.
+// every worker has its own queue of jobs and takes from its back,
+// a worker (or the calling thread) that runs out of jobs steals
+// from the front of someone else's queue, so a slow chunk never
+// leaves the other cores idle.
+// parallelFor() only hands out index ranges, what each range
+// produces is up to the caller, so results that are written per
+// index and gathered in index order afterwards come out exactly
+// the same no matter how the ranges were split or who ran them.
+class JobSystem
+{
+public:
+    // bytes in a cache line on every machine we care about
+    static constexpr std::size_t cacheLineSize{64};
+
+    // the most workers a command line may ask for,
+    // anything above is a typo rather than a machine
+    static constexpr unsigned maxWorkerCount{1024};
+
+    // workerCount 0 uses every core except the calling one
+    explicit JobSystem(unsigned workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    // workers plus the thread calling parallelFor()
+    unsigned getThreadCount() const;
+
+    // how many T fit in one cache line
+    template <typename T>
+    static constexpr std::size_t getPerCacheLine()
+    {
+        return std::max<std::size_t>(1, cacheLineSize / sizeof(T));
+    }
+
+    // how big the ranges of a count long loop should be
+    // ranges are a whole number of granularity elements, so two
+    // threads never write the same cache line of an array of
+    // granularity-per-line elements (except at a misaligned start),
+    // and there are a few more ranges than threads for stealing
+    std::size_t getChunkSize(std::size_t count, std::size_t granularity) const;
+
+    // call function(first, last) for ranges covering [0, count)
+    // and return once every range has run
+    // the calling thread runs ranges too instead of just waiting.
+    // must not be called from inside a job
+    template <typename Function>
+    void parallelFor(std::size_t count, std::size_t granularity, Function &&function)
+    {
+        split(count, getChunkSize(count, granularity), function);
+    }
+
+    // parallelFor() for a few long running iterations (whole games,
+    // say): the ranges are only as big as stealing wants, without
+    // the cache line minimum, so a handful of iterations still
+    // spreads over every thread
+    template <typename Function>
+    void parallelForHeavy(std::size_t count, Function &&function)
+    {
+        split(count, getStealChunkSize(count), function);
+    }
+
+private:
+    // a few more ranges than threads, at least one element each
+    std::size_t getStealChunkSize(std::size_t count) const;
+
+    template <typename Function>
+    void split(std::size_t count, std::size_t chunkSize, Function &function)
+    {
+        // not worth waking anybody up for
+        if (chunkSize >= count)
+        {
+            if (count > 0)
+                function(std::size_t{0}, count);
+
+            return;
+        }
+
+        run(count, chunkSize, &invoke<Function>, &function);
+    }
+
+    // a type erased function(first, last), so jobs don't allocate
+    using Invoke = void (*)(void *context, std::size_t first, std::size_t last);
+
+    template <typename Function>
+    static void invoke(void *context, std::size_t first, std::size_t last)
+    {
+        (*static_cast<Function *>(context))(first, last);
+    }
+
+    struct Job
+    {
+        Invoke invoke{};
+        void *context{};
+        std::size_t first{};
+        std::size_t last{};
+
+        // counts down the unfinished ranges of one parallelFor()
+        std::atomic<std::size_t> *remaining{};
+    };
+
+    // a fixed ring of jobs guarded by its own lock
+    // only the owning worker pops from the back,
+    // everybody else steals from the front
+    struct alignas(cacheLineSize) WorkQueue
+    {
+        static constexpr std::size_t capacity{256};
+
+        std::mutex mutex{};
+        std::array<Job, capacity> jobs{};
+        std::size_t head{};
+        std::size_t tail{};
+    };
+
+    void run(std::size_t count, std::size_t chunkSize, Invoke call, void *context);
+
+    void workerLoop(std::size_t self);
+
+    bool push(std::size_t queue, const Job &job);
+    bool popBack(std::size_t queue, Job &job);
+    bool stealFront(std::size_t queue, Job &job);
+
+    // self's own queue first, then every other one
+    bool findJob(std::size_t self, Job &job);
+
+    static void execute(const Job &job);
+
+    std::vector<WorkQueue> m_queues;
+
+    // jobs sitting in any queue, idle workers sleep while it's 0
+    std::atomic<std::size_t> m_queued{};
+
+    std::mutex m_sleepMutex{};
+    std::condition_variable m_wake{};
+    bool m_stopping{};
+
+    // last, so workers are started after everything they use
+    std::vector<std::jthread> m_workers{};
+};
+
+#endif
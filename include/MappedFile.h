@@ -0,0 +1,38 @@
+#include <span>    // for std::span
+#include <string>  // for std::string
+#include <vector>  // for std::vector
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+// a whole file mapped read-only into memory
+// pages are only read from disk when they are touched,
+// so streaming through a big file never loads all of it.
+// where mmap isn't available the file is read instead.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // false if the file couldn't be opened or mapped
+    bool isOpen() const;
+
+    std::span<const std::uint8_t> getBytes() const;
+    std::size_t getSize() const;
+
+private:
+    const std::uint8_t *m_data{};
+    std::size_t m_size{};
+    bool m_isOpen{};
+
+    // the file's bytes when it had to be read instead of mapped
+    std::vector<std::uint8_t> m_fallback{};
+};
+
+#endif
@@ -1,9 +1,24 @@
 #include "Line2D.h"
 #include <raylib.h>
+#include <cstdint> // for std::uint8_t
+#include <cstddef> // for std::size_t
 
 #ifndef MISSILE_H
 #define MISSILE_H
 
+// who fired a missile
+// the world keeps every faction in a store of its own, so
+// what a missile may hit is decided by which store it's
+// in and not by looking at each one. the colour it's
+// drawn in is only picked when it's drawn
+enum class Faction : std::uint8_t
+{
+    player,
+    enemy,
+};
+
+constexpr std::size_t factionCount{2};
+
 class Missile : public Line2D
 {
 public:
@@ -17,10 +32,14 @@ public:
     void setTargetPos(const Vector2 &position);
     const Vector2 &getTargetPos() const;
 
+    void setFaction(Faction faction);
+    Faction getFaction() const;
+
 private:
     float m_missileDistance{};
     Vector2 m_targetPos{};
     float m_missileSpeed{};
+    Faction m_faction{Faction::enemy};
 };
 
 #endif
\ No newline at end of file
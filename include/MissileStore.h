@@ -0,0 +1,185 @@
+#include "Missile.h"
+#include "SlotMap.h"
+#include "ByteStream.h"
+#include <raylib.h>
+#include <vector>  // for std::vector
+#include <span>    // for std::span
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t, std::uint32_t, std::uint64_t
+
+#ifndef MISSILE_STORE_H
+#define MISSILE_STORE_H
+
+// stores every missile as a structure of arrays
+// instead of a list of Missile objects.
+// each property lives in its own contiguous array
+// so evaluating positions walks memory linearly
+// and can handle 4 (SSE) or 8 (AVX) missiles at once.
+// every array is reserved once for the capacity
+// so pushing and erasing never allocate.
+// a store holds the missiles of one faction only, so
+// there is nothing in it about who fired them.
+//
+// a missile never gets stepped. it stands still on the tick
+// after its launch, then moves speed, 2 * speed, ... units a
+// tick until it moves topSpeed units per tick (the very steps
+// the game always took, summed up), so where it is only
+// depends on how many ticks ago it was launched.
+// positions are worked out from that when they are needed
+// and the tick a missile reaches its target is known the
+// moment it's launched.
+class MissileStore
+{
+public:
+    // topSpeed is the most any missile moves in one tick
+    MissileStore(std::size_t capacity, float topSpeed);
+
+    // copy a fully setup missile launched on launchTick into the store
+    // like Pool, a full store refuses the missile,
+    // returns an invalid handle and counts the overflow
+    Handle push(const Missile &missile, std::uint64_t launchTick);
+
+    // returns false if the missile was already removed
+    bool erase(const Handle &handle);
+
+    // remove a whole batch in one sweep over the arrays
+    // stale and repeated handles are ignored and the
+    // surviving missiles keep their relative order
+    void erase(std::span<const Handle> handles);
+
+    void clear();
+
+    std::size_t size() const;
+    bool empty() const;
+    std::size_t getCapacity() const;
+    std::uint64_t getOverflowCount() const;
+
+    // heap memory held by the store, like Pool
+    // it's reserved up front and never shrinks
+    std::size_t getReservedBytes() const;
+
+    // the handle of the missile at index
+    Handle getHandle(std::size_t index) const;
+
+    // the index of a missile, or SlotMap::npos if it's gone
+    std::size_t find(const Handle &handle) const;
+
+    Vector2 getStartPos(std::size_t index) const;
+    Vector2 getTargetPos(std::size_t index) const;
+    float getMissileSpeed(std::size_t index) const;
+    std::uint64_t getArrivalTick(std::size_t index) const;
+
+    // the flight of the missile as evaluate() sees it: the unit
+    // vector along its path, the length of the path, the ticks
+    // it speeds up for and its (fractional) age at tick
+    Vector2 getDirection(std::size_t index) const;
+    float getLength(std::size_t index) const;
+    float getRampTicks(std::size_t index) const;
+    float getAge(std::size_t index, double tick) const;
+
+    // the head of the missile as of the last evaluate()
+    Vector2 getEndPos(std::size_t index) const;
+
+    // the head of the missile at any (even fractional) tick
+    // computed on the spot, nothing is cached
+    Vector2 getEndPos(std::size_t index, double tick) const;
+
+    // the head of the missile at a whole tick, bit for bit
+    // what evaluate() works out for it, and cheaper than
+    // the fractional one
+    Vector2 getEndPosOnTick(std::size_t index, std::uint64_t tick) const;
+
+    // work out the head of every missile at tick
+    // picks the widest SIMD path the compiler was allowed to use
+    void evaluate(std::uint64_t tick);
+
+    // evaluate() only the missiles in [first, last)
+    // missiles don't depend on each other, so separate
+    // ranges can be evaluated on separate threads
+    void evaluate(std::uint64_t tick, std::size_t first, std::size_t last);
+
+    // same as evaluate() but one missile at a time
+    // produces bit-identical results to the SIMD path
+    void evaluateScalar(std::uint64_t tick);
+
+    // every missile whose arrival tick is <= tick
+    // each missile is reported once, on the first call
+    // that reaches its arrival tick
+    std::span<const Handle> collectArrivals(std::uint64_t tick);
+
+    // blit every array into writer / back from reader
+    // restoring needs a store of the same capacity
+    void saveState(ByteWriter &writer) const;
+    bool restoreState(ByteReader &reader);
+
+    float getTopSpeed() const;
+
+    // distance travelled age ticks after launch
+    static float getTravelled(float age, float speed, float rampTicks, float topSpeed);
+
+    // the ticks a missile of speed speeds up for, the
+    // rampTicks of getTravelled() (infinite for speed <= 0)
+    static float getRampTicks(float speed, float topSpeed);
+
+    // the first whole tick after launch on which a missile
+    // has travelled length, the same tick push() works out
+    static std::uint64_t getArrivalAge(float length, float speed, float topSpeed);
+
+private:
+    void evaluateScalar(std::uint32_t tick, std::size_t first, std::size_t last);
+
+    // the head of the missile at index on tick (the low 32 bits)
+    Vector2 evaluateScalar(std::uint32_t tick, std::size_t index) const;
+
+    SlotMap m_slots;
+    float m_topSpeed{};
+    std::uint64_t m_overflowCount{};
+
+    // scratch flags for erase(std::span), one per capacity
+    std::vector<std::uint8_t> m_dead{};
+
+    std::vector<float> m_startX{};
+    std::vector<float> m_startY{};
+
+    // unit vector from start to target and the length of that path
+    std::vector<float> m_dirX{};
+    std::vector<float> m_dirY{};
+    std::vector<float> m_length{};
+
+    std::vector<float> m_targetX{};
+    std::vector<float> m_targetY{};
+
+    // how much faster the missile gets every tick and
+    // how many ticks it takes to reach its top speed
+    std::vector<float> m_speed{};
+    std::vector<float> m_rampTicks{};
+
+    // the low 32 bits are enough, only the age
+    // (tick - launch tick) is ever used
+    std::vector<std::uint32_t> m_launchTick{};
+    std::vector<std::uint64_t> m_arrivalTick{};
+
+    // the head of the missile as of the last evaluate()
+    std::vector<float> m_x{};
+    std::vector<float> m_y{};
+
+    // a min-heap of upcoming arrivals
+    // entries of erased missiles are dropped when they come up
+    // or when erase() rebuilds the heap, whichever is first
+    struct Arrival
+    {
+        std::uint64_t tick{};
+        Handle handle{};
+    };
+
+    // orders the heap so the earliest arrival is on top
+    static bool arrivesLater(const Arrival &a, const Arrival &b);
+
+    // the heap again from the live missiles only
+    void rebuildArrivals();
+
+    std::vector<Arrival> m_arrivals{};
+    std::vector<Handle> m_arrived{};
+};
+
+#endif
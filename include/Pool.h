@@ -0,0 +1,186 @@
+#include "SlotMap.h"
+#include "ByteStream.h"
+#include <vector>    // for std::vector
+#include <span>      // for std::span
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint8_t, std::uint64_t
+#include <utility>   // for std::move
+#include <algorithm> // for std::fill
+
+#ifndef POOL_H
+#define POOL_H
+
+// a fixed-capacity pool of entities
+// entities are kept packed in one array, so iterating
+// a pool is a plain linear walk over memory.
+// the array is reserved once for the capacity, so
+// spawn() and despawn() are O(1) and never allocate.
+// a handle stays valid until its entity is despawned,
+// even though despawning moves other entities around.
+template <typename T>
+class Pool
+{
+public:
+    explicit Pool(std::size_t capacity)
+        : m_slots{capacity},
+          m_dead(capacity, 0)
+    {
+        m_items.reserve(capacity);
+    }
+
+    // overflow policy: spawning into a full pool is refused,
+    // an invalid handle is returned and the overflow is counted
+    Handle spawn(const T &item)
+    {
+        const Handle handle{m_slots.insert()};
+
+        if (!handle.isValid())
+        {
+            ++m_overflowCount;
+            return handle;
+        }
+
+        m_items.push_back(item);
+        return handle;
+    }
+
+    // returns false if the handle was already despawned
+    bool despawn(const Handle &handle)
+    {
+        const std::size_t index{m_slots.find(handle)};
+
+        if (index == SlotMap::npos)
+            return false;
+
+        despawnAt(index);
+        return true;
+    }
+
+    // despawn by dense index
+    // the last entity is moved into index
+    void despawnAt(std::size_t index)
+    {
+        m_slots.eraseAt(index);
+
+        if (index != m_items.size() - 1)
+            m_items[index] = std::move(m_items.back());
+
+        m_items.pop_back();
+    }
+
+    // despawn a whole batch in one sweep over the pool
+    // stale and repeated handles are ignored and the
+    // surviving entities keep their relative order
+    void despawn(std::span<const Handle> handles)
+    {
+        bool anyDead{false};
+
+        for (const Handle &handle : handles)
+        {
+            const std::size_t index{m_slots.find(handle)};
+
+            if (index != SlotMap::npos)
+            {
+                m_dead[index] = 1;
+                anyDead = true;
+            }
+        }
+
+        if (!anyDead)
+            return;
+
+        std::size_t write{0};
+
+        for (std::size_t read{0}; read < m_items.size(); ++read)
+        {
+            if (m_dead[read])
+                continue;
+
+            if (write != read)
+                m_items[write] = std::move(m_items[read]);
+
+            ++write;
+        }
+
+        m_slots.compact(std::span<const std::uint8_t>{m_dead.data(), m_items.size()});
+
+        // reset only the flags that were used
+        std::fill(m_dead.begin(), m_dead.begin() + static_cast<std::ptrdiff_t>(m_items.size()), 0);
+
+        m_items.erase(m_items.begin() + static_cast<std::ptrdiff_t>(write), m_items.end());
+    }
+
+    // nullptr if the handle was despawned
+    T *get(const Handle &handle)
+    {
+        const std::size_t index{m_slots.find(handle)};
+        return index == SlotMap::npos ? nullptr : &m_items[index];
+    }
+
+    const T *get(const Handle &handle) const
+    {
+        const std::size_t index{m_slots.find(handle)};
+        return index == SlotMap::npos ? nullptr : &m_items[index];
+    }
+
+    Handle getHandle(std::size_t index) const { return m_slots.getHandle(index); }
+
+    T &operator[](std::size_t index) { return m_items[index]; }
+    const T &operator[](std::size_t index) const { return m_items[index]; }
+
+    void clear()
+    {
+        m_slots.clear();
+        m_items.clear();
+    }
+
+    std::size_t size() const { return m_items.size(); }
+    bool empty() const { return m_items.empty(); }
+    bool full() const { return m_slots.full(); }
+    std::size_t getCapacity() const { return m_slots.getCapacity(); }
+
+    // heap memory held by the pool, all of it
+    // reserved up front, so it's also the most it ever holds
+    std::size_t getReservedBytes() const
+    {
+        return m_slots.getReservedBytes() + m_items.capacity() * sizeof(T) + m_dead.capacity();
+    }
+
+    // number of spawns refused because the pool was full
+    std::uint64_t getOverflowCount() const { return m_overflowCount; }
+
+    // blit the whole pool into writer / back from reader
+    // entities are copied as raw bytes, so T has to be trivially
+    // copyable. restoring needs a pool of the same capacity
+    void saveState(ByteWriter &writer) const
+    {
+        m_slots.saveState(writer);
+        writer.writeArray(std::span{m_items});
+        writer.writeVarint(m_overflowCount);
+    }
+
+    bool restoreState(ByteReader &reader)
+    {
+        const bool slotsRestored{m_slots.restoreState(reader)};
+
+        reader.readArray(m_items, m_slots.getCapacity());
+        m_overflowCount = reader.readVarint();
+
+        return slotsRestored && !reader.hasFailed() && m_items.size() == m_slots.size();
+    }
+
+    auto begin() { return m_items.begin(); }
+    auto end() { return m_items.end(); }
+    auto begin() const { return m_items.begin(); }
+    auto end() const { return m_items.end(); }
+
+private:
+    SlotMap m_slots;
+    std::vector<T> m_items{};
+
+    // scratch flags for despawn(std::span), one per capacity
+    std::vector<std::uint8_t> m_dead{};
+    std::uint64_t m_overflowCount{};
+};
+
+#endif
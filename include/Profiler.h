@@ -0,0 +1,102 @@
+#include "AllocationTracker.h"
+#include <vector>  // for std::vector
+#include <string>  // for std::string
+#include <span>    // for std::span
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint32_t, std::uint64_t
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// scoped timers for the phases of a tick and of a frame.
+// every PROFILE_SCOPE() writes one sample (name, start, duration,
+// thread) into a fixed ring shared by all threads. writers claim
+// a slot with a single atomic add and never wait for anybody, old
+// samples are simply overwritten once the ring wraps around.
+//
+// unless MISSILE_COMMANDER_PROFILE is defined (cmake option of the
+// same name) PROFILE_SCOPE() doesn't time anything, so a normal
+// build doesn't even read the clock.
+namespace Profiler
+{
+    struct Sample
+    {
+        // a string literal, samples only keep the pointer
+        const char *name{};
+        std::uint64_t startNs{};
+        std::uint64_t durationNs{};
+        std::uint32_t thread{};
+    };
+
+    struct PhaseStats
+    {
+        const char *name{};
+        std::size_t count{};
+        double p50Ms{};
+        double p99Ms{};
+    };
+
+    // nanoseconds on a steady clock
+    std::uint64_t now();
+
+    // called by ProfileScope, safe from any thread
+    void record(const char *name, std::uint64_t startNs, std::uint64_t durationNs);
+
+    // replace samples with every sample still in the ring, oldest first
+    void collect(std::vector<Sample> &samples);
+
+    // median and 99th percentile duration of every phase
+    // samples gets sorted along the way
+    void computeStats(std::vector<Sample> &samples, std::vector<PhaseStats> &stats);
+
+    // write samples as a chrome trace (chrome://tracing, perfetto)
+    // returns false if the file couldn't be written
+    bool exportChromeTrace(std::span<const Sample> samples, const std::string &path);
+}
+
+// times the scope it lives in
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char *name)
+        : m_name{name},
+          m_start{Profiler::now()}
+    {
+    }
+
+    ~ProfileScope()
+    {
+        Profiler::record(m_name, m_start, Profiler::now() - m_start);
+    }
+
+    ProfileScope(const ProfileScope &) = delete;
+    ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+    const char *m_name{};
+    std::uint64_t m_start{};
+};
+
+// with MISSILE_COMMANDER_TRACK_ALLOCATIONS every scope is also
+// a phase the allocations made inside it are counted towards,
+// see AllocationTracker.h
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if defined(MISSILE_COMMANDER_PROFILE)
+#define PROFILE_TIME_SCOPE(name) const ProfileScope PROFILE_CONCAT(profileScope, __LINE__) { name }
+#else
+#define PROFILE_TIME_SCOPE(name) static_cast<void>(0)
+#endif
+
+#if defined(MISSILE_COMMANDER_TRACK_ALLOCATIONS)
+#define PROFILE_ALLOCATION_SCOPE(name) const AllocationScope PROFILE_CONCAT(allocationScope, __LINE__) { name }
+#else
+#define PROFILE_ALLOCATION_SCOPE(name) static_cast<void>(0)
+#endif
+
+#define PROFILE_SCOPE(name) \
+    PROFILE_ALLOCATION_SCOPE(name); \
+    PROFILE_TIME_SCOPE(name)
+
+#endif
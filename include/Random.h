@@ -1,72 +1,172 @@
-#ifndef RANDOM_MT_H
-#define RANDOM_MT_H
+#include <span>    // for std::span
+#include <random>  // for std::random_device
+#include <chrono>  // for std::chrono::steady_clock
+#include <cstdint> // for std::uint32_t, std::uint64_t, std::int64_t
+#include <limits>  // for std::numeric_limits
+#include <cmath>   // for std::nextafter
 
-#include <chrono>
-#include <random>
+#ifndef RANDOM_H
+#define RANDOM_H
 
-// This header-only Random namespace implements a self-seeding Mersenne Twister.
-// Requires C++17 or newer.
-// It can be #included into as many code files as needed (The inline keyword avoids ODR violations)
-// Freely redistributable, courtesy of learncpp.com (https://www.learncpp.com/cpp-tutorial/global-random-numbers-random-h/)
 namespace Random
 {
-    // Returns a seeded Mersenne Twister
-    // Note: we'd prefer to return a std::seed_seq (to initialize a std::mt19937), but std::seed can't be copied, so it can't be returned by value.
-    // Instead, we'll create a std::mt19937, seed it, and then return the std::mt19937 (which can be copied).
-    inline std::mt19937 generate()
+    // a PCG32 (XSH-RR) random number generator
+    // 16 bytes of state instead of the 5 KB of a std::mt19937,
+    // and the same seed always gives the same numbers on
+    // every compiler and platform, which std::mt19937 combined
+    // with the std:: distributions doesn't promise.
+    //
+    // every (seed, stream) pair is its own independent sequence,
+    // so subsystems and threads can share one seed and still
+    // never draw the same numbers. split() hands out a new
+    // generator on a stream of its own.
+    //
+    // it's a UniformRandomBitGenerator, so it still works
+    // with the std:: distributions if one is ever needed.
+    class Pcg32
     {
-        std::random_device rd{};
+    public:
+        using result_type = std::uint32_t;
 
-        // Create seed_seq with clock and 7 random numbers from std::random_device
-        std::seed_seq ss{
-            static_cast<std::seed_seq::result_type>(std::chrono::steady_clock::now().time_since_epoch().count()),
-            rd(), rd(), rd(), rd(), rd(), rd(), rd()};
+        explicit Pcg32(std::uint64_t seed, std::uint64_t stream = 0)
+            : m_increment{(stream << 1u) | 1u}
+        {
+            next();
+            m_state += seed;
+            next();
+        }
 
-        return std::mt19937{ss};
-    }
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
 
-    // Here's our global std::mt19937 object.
-    // The inline keyword means we only have one global instance for our whole program.
-    inline std::mt19937 mt{generate()}; // generates a seeded std::mt19937 and copies it into our global object
+        result_type operator()() { return next(); }
 
-    // Generate a random int between [min, max] (inclusive)
-    // * also handles cases where the two arguments have different types but can be converted to int
-    inline int get(int min, int max)
-    {
-        return std::uniform_int_distribution{min, max}(mt);
-    }
+        // 32 uniformly random bits
+        std::uint32_t next()
+        {
+            const std::uint64_t old{m_state};
+            m_state = old * multiplier + m_increment;
 
-    // The following function templates can be used to generate random numbers in other cases
-
-    // See https://www.learncpp.com/cpp-tutorial/function-template-instantiation/
-    // You can ignore these if you don't understand them
-
-    // Generate a random value between [min, max] (inclusive)
-    // * min and max must have the same type
-    // * return value has same type as min and max
-    // * Supported types:
-    // *    short, int, long, long long
-    // *    unsigned short, unsigned int, unsigned long, or unsigned long long
-    // Sample call: Random::get(1L, 6L);             // returns long
-    // Sample call: Random::get(1u, 6u);             // returns unsigned int
-    template <typename T>
-    T get(T min, T max)
-    {
-        return std::uniform_int_distribution<T>{min, max}(mt);
-    }
+            const auto xorShifted{static_cast<std::uint32_t>(((old >> 18u) ^ old) >> 27u)};
+            const auto rotation{static_cast<std::uint32_t>(old >> 59u)};
+
+            return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31u));
+        }
+
+        std::uint64_t next64()
+        {
+            const std::uint64_t high{next()};
+            return (high << 32u) | next();
+        }
+
+        // a uniform integer in [0, bound), bound must be > 0
+        // Lemire's multiply and shift: no division in the common
+        // case and, unlike next() % bound, no bias towards small values
+        std::uint32_t nextBounded(std::uint32_t bound)
+        {
+            std::uint64_t product{static_cast<std::uint64_t>(next()) * bound};
+            auto low{static_cast<std::uint32_t>(product)};
+
+            if (low < bound)
+            {
+                // the 2^32 % bound lowest values would be picked once
+                // too often, throw them away and draw again
+                const std::uint32_t threshold{(0u - bound) % bound};
+
+                while (low < threshold)
+                {
+                    product = static_cast<std::uint64_t>(next()) * bound;
+                    low = static_cast<std::uint32_t>(product);
+                }
+            }
+
+            return static_cast<std::uint32_t>(product >> 32u);
+        }
+
+        // a uniform integer in [min, max] (inclusive)
+        int getInt(int min, int max)
+        {
+            const auto range{static_cast<std::uint64_t>(static_cast<std::int64_t>(max) - min) + 1};
+
+            // [INT_MIN, INT_MAX] is every 32 bit value
+            if (range > std::numeric_limits<std::uint32_t>::max())
+                return static_cast<int>(static_cast<std::int64_t>(min) + next());
+
+            return static_cast<int>(static_cast<std::int64_t>(min) + nextBounded(static_cast<std::uint32_t>(range)));
+        }
 
-    // Generate a random value between [min, max] (inclusive)
-    // * min and max can have different types
-    // * return type must be explicitly specified as a template argument
-    // * min and max will be converted to the return type
-    // Sample call: Random::get<std::size_t>(0, 6);  // returns std::size_t
-    // Sample call: Random::get<std::size_t>(0, 6u); // returns std::size_t
-    // Sample call: Random::get<std::int>(0, 6u);    // returns int
-    template <typename R, typename S, typename T>
-    R get(S min, T max)
+        // a uniform float in [0, 1)
+        // the top 24 bits fill the whole mantissa exactly
+        float getFloat()
+        {
+            return static_cast<float>(next() >> 8u) * 0x1.0p-24f;
+        }
+
+        // a uniform float in [min, max), or min if they're equal
+        // the sum can round up to max itself, that draw
+        // becomes the last float before max instead
+        float getFloat(float min, float max)
+        {
+            const float value{min + (max - min) * getFloat()};
+
+            return (value == max && min != max) ? std::nextafter(max, min) : value;
+        }
+
+        // a new generator on its own stream, seeded from this one
+        // e.g. one per worker thread or per wave
+        Pcg32 split()
+        {
+            const std::uint64_t seed{next64()};
+            return Pcg32{seed, next64()};
+        }
+
+        // bulk versions, for spawning a whole wave at once
+        // they draw exactly the numbers the one-at-a-time
+        // functions would, in the same order
+        void fill(std::span<std::uint32_t> values)
+        {
+            for (std::uint32_t &value : values)
+                value = next();
+        }
+
+        void fillInts(std::span<int> values, int min, int max)
+        {
+            for (int &value : values)
+                value = getInt(min, max);
+        }
+
+        void fillFloats(std::span<float> values, float min, float max)
+        {
+            for (float &value : values)
+                value = getFloat(min, max);
+        }
+
+        std::uint64_t getState() const { return m_state; }
+        std::uint64_t getIncrement() const { return m_increment; }
+
+    private:
+        static constexpr std::uint64_t multiplier{6364136223846793005ull};
+
+        std::uint64_t m_state{};
+
+        // always odd, picks the stream
+        std::uint64_t m_increment{};
+    };
+
+    // a seed nobody can predict, for games that should
+    // be different every time they are played
+    // everything after the seed is reproducible
+    inline std::uint64_t generateSeed()
     {
-        return get<R>(static_cast<R>(min), static_cast<R>(max));
+        std::random_device device{};
+
+        const auto clock{static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count())};
+        const std::uint64_t entropy{(static_cast<std::uint64_t>(device()) << 32u) | device()};
+
+        // run the two through a generator so
+        // nearby clock values end up far apart
+        return Pcg32{clock, entropy}.next64();
     }
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,58 @@
+#include "Missile.h"
+#include <raylib.h>
+#include <vector>  // for std::vector
+#include <cstdint> // for std::uint64_t
+
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+// everything needed to draw one tick of the world,
+// copied out of it so the drawing thread never
+// touches the world the simulation thread is stepping.
+// every entity carries its state on the previous and
+// the last tick so drawing can blend between them.
+struct RenderSnapshot
+{
+    struct MissileView
+    {
+        Vector2 startPos{};
+        Vector2 previousEndPos{};
+        Vector2 endPos{};
+
+        // the colour it's drawn in is picked from this
+        Faction faction{};
+    };
+
+    struct ExplosionView
+    {
+        Vector2 position{};
+        float previousRadius{};
+        float radius{};
+        Color tint{};
+    };
+
+    struct BuildingView
+    {
+        Rectangle rectangle{};
+        Color tint{};
+    };
+
+    std::vector<MissileView> missiles{};
+    std::vector<ExplosionView> explosions{};
+    std::vector<BuildingView> buildings{};
+
+    std::uint64_t tick{};
+    bool isOver{};
+
+    // changes whenever buildings does, a cached drawing of
+    // the city only needs redrawing when this is new
+    std::uint64_t buildingsVersion{};
+
+    // when the snapshot was published and how long a tick is,
+    // both in seconds, so the reader can tell how far it is
+    // between this tick and the next
+    double publishedAt{};
+    double tickSeconds{};
+};
+
+#endif
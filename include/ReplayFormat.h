@@ -0,0 +1,46 @@
+#include <array>   // for std::array
+#include <cstdint> // for std::uint8_t
+
+#ifndef REPLAY_FORMAT_H
+#define REPLAY_FORMAT_H
+
+// the layout of a replay file
+//
+//   header:  "MCRP", version (u8), the world config (World::writeConfig(),
+//            the scenario included), hash interval (varint)
+//   records: varint (ticks since the previous record << 3 | kind)
+//            followed by the kind's payload
+//
+// a record belongs to the tick it skips to, a tick without
+// input and without a hash costs nothing at all.
+// fire targets on whole pixels (what a mouse gives) are stored
+// as zigzag deltas from the previous target, anything else
+// as the exact float bits.
+namespace ReplayFormat
+{
+    constexpr std::array<std::uint8_t, 4> magic{'M', 'C', 'R', 'P'};
+    constexpr std::uint8_t version{8};
+
+    enum class Record : std::uint8_t
+    {
+        // skips to the total number of ticks, nothing follows it
+        end,
+
+        // zigzag dx, zigzag dy from the previous pixel target
+        firePixel,
+
+        // x, y as raw floats
+        fireExact,
+
+        // the low 32 bits of World::getStateHash() after the tick
+        hash,
+
+        // enemy missiles launched by a WaveDirector (varint)
+        enemies,
+    };
+
+    // the low bits of a record header that hold its kind
+    constexpr unsigned kindBits{3};
+}
+
+#endif
@@ -0,0 +1,69 @@
+#include "World.h"
+#include "InputFrame.h"
+#include "ByteStream.h"
+#include <span>    // for std::span
+#include <cstdint> // for std::uint8_t, std::uint32_t, std::uint64_t, std::int64_t
+
+#ifndef REPLAY_READER_H
+#define REPLAY_READER_H
+
+// what a replay holds for one tick
+struct ReplayTick
+{
+    InputFrame input{};
+
+    // the world's hash after the tick, if one was recorded
+    bool hasHash{};
+    std::uint32_t hash{};
+};
+
+// streams a replay file (see ReplayFormat.h) tick by tick
+// straight out of its bytes, usually a MappedFile, so
+// nothing but the record being decoded is ever copied
+class ReplayReader
+{
+public:
+    explicit ReplayReader(std::span<const std::uint8_t> bytes);
+
+    // false if the header is broken or from another version
+    bool isValid() const;
+
+    // the world the replay was recorded in
+    const WorldConfig &getConfig() const;
+    std::uint32_t getHashInterval() const;
+
+    // the next tick of the replay
+    // returns false once every tick was read or if the
+    // file turns out to be broken (see hasFailed())
+    bool readTick(ReplayTick &tick);
+
+    bool hasFailed() const;
+
+    // ticks read so far
+    std::uint64_t getTick() const;
+
+private:
+    // decode the next record into m_record...
+    void readRecord();
+
+    ByteReader m_reader;
+    WorldConfig m_config{};
+    std::uint32_t m_hashInterval{};
+    bool m_valid{};
+    bool m_failed{};
+
+    std::uint64_t m_tick{};
+
+    // the next record, not handed out yet
+    std::uint64_t m_recordTick{};
+    std::uint8_t m_recordKind{};
+    Vector2 m_recordTarget{};
+    std::uint32_t m_recordHash{};
+    std::uint32_t m_recordEnemies{};
+
+    // the previous pixel target
+    std::int64_t m_lastX{};
+    std::int64_t m_lastY{};
+};
+
+#endif
@@ -0,0 +1,58 @@
+#include "World.h"
+#include "InputFrame.h"
+#include <vector>  // for std::vector
+#include <string>  // for std::string
+#include <fstream> // for std::ofstream
+#include <cstdint> // for std::uint8_t, std::uint32_t, std::uint64_t, std::int64_t
+
+#ifndef REPLAY_RECORDER_H
+#define REPLAY_RECORDER_H
+
+// writes the seed, the input of every tick and a hash of the
+// world every hashInterval ticks into a replay file
+// (see ReplayFormat.h), so a game can be played back exactly.
+// records are buffered and written in big blocks.
+class ReplayRecorder
+{
+public:
+    ReplayRecorder(const std::string &path, const WorldConfig &config, std::uint32_t hashInterval = 1);
+
+    // finishes the file
+    ~ReplayRecorder();
+
+    ReplayRecorder(const ReplayRecorder &) = delete;
+    ReplayRecorder &operator=(const ReplayRecorder &) = delete;
+
+    // false if the file couldn't be created or written
+    bool isOpen() const;
+
+    // call right after world.step(input)
+    void recordTick(const InputFrame &input, const World &world);
+
+    // write the end of the replay and close the file
+    // ticks recorded after this are ignored
+    void finish();
+
+    std::uint64_t getTicks() const;
+
+private:
+    void writeRecord(std::uint8_t kind);
+    void flush();
+
+    std::ofstream m_file;
+    std::vector<std::uint8_t> m_buffer{};
+
+    std::uint32_t m_hashInterval{};
+
+    // ticks recorded so far, the tick of the last record
+    std::uint64_t m_ticks{};
+    std::uint64_t m_recordTick{};
+
+    // the previous pixel target, fire targets are stored relative to it
+    std::int64_t m_lastX{};
+    std::int64_t m_lastY{};
+
+    bool m_finished{};
+};
+
+#endif
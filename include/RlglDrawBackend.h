@@ -0,0 +1,31 @@
+#include "DrawList.h"
+#include <raylib.h>
+#include <span> // for std::span
+
+#ifndef RLGL_DRAW_BACKEND_H
+#define RLGL_DRAW_BACKEND_H
+
+// draws a DrawList straight through rlgl, raylib's batching layer.
+// every batch is one rlBegin()/rlEnd() with one texture, so
+// rlgl turns it into a single draw call (or a few, if it
+// overflows rlgl's vertex buffer) however many shapes are in it.
+// circles are textured quads of a disc texture instead of
+// the triangle fans DrawCircleV() builds, 4 vertices each.
+// needs a window (an OpenGL context) for as long as it lives
+class RlglDrawBackend : public DrawBackend
+{
+public:
+    RlglDrawBackend();
+    ~RlglDrawBackend() override;
+
+    void drawBatch(const DrawBatch &batch, std::span<const DrawCommand> commands) override;
+
+private:
+    void drawLines(std::span<const DrawCommand> commands) const;
+    void drawQuads(std::span<const DrawCommand> commands, const Texture2D &texture, const Rectangle &source) const;
+
+    // a white disc on a transparent background
+    Texture2D m_circle{};
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "ScenarioFormat.h"
+#include <span>     // for std::span
+#include <vector>   // for std::vector
+#include <optional> // for std::optional
+#include <cstdint>  // for std::uint8_t, std::uint64_t
+
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+// a compiled scenario (see ScenarioFormat.h) used straight out
+// of its bytes, usually a MappedFile. the constructor checks the
+// header and every value once, from then on the getters only
+// hand out views into the bytes, which have to outlive them.
+// the buildings have to fit the world the scenario is played
+// in, standing on its ground (worldHeight) between 0 and worldWidth.
+// a default constructed view is the built-in game: no seed and
+// no buildings, launch sites or waves of its own
+class ScenarioView
+{
+public:
+    ScenarioView() = default;
+    ScenarioView(std::span<const std::uint8_t> bytes, float worldWidth, float worldHeight);
+
+    // false if the bytes aren't a scenario of this version, are
+    // broken, don't start at a multiple of ScenarioFormat::alignment
+    // or have a building that doesn't fit the world
+    bool isValid() const;
+
+    std::optional<std::uint64_t> getSeed() const;
+
+    std::span<const ScenarioFormat::Building> getBuildings() const;
+    std::span<const ScenarioFormat::LaunchSite> getLaunchSites() const;
+    std::span<const ScenarioFormat::Wave> getWaves() const;
+
+private:
+    bool m_valid{};
+    std::optional<std::uint64_t> m_seed{};
+
+    std::span<const ScenarioFormat::Building> m_buildings{};
+    std::span<const ScenarioFormat::LaunchSite> m_launchSites{};
+    std::span<const ScenarioFormat::Wave> m_waves{};
+};
+
+// collects a scenario and writes it out compiled
+class ScenarioBuilder
+{
+public:
+    void setSeed(std::uint64_t seed);
+
+    void addBuilding(const ScenarioFormat::Building &building);
+    void addLaunchSite(const ScenarioFormat::LaunchSite &launchSite);
+    void addWave(const ScenarioFormat::Wave &wave);
+
+    // replace bytes with the compiled scenario
+    void write(std::vector<std::uint8_t> &bytes) const;
+
+private:
+    std::optional<std::uint64_t> m_seed{};
+
+    std::vector<ScenarioFormat::Building> m_buildings{};
+    std::vector<ScenarioFormat::LaunchSite> m_launchSites{};
+    std::vector<ScenarioFormat::Wave> m_waves{};
+};
+
+#endif
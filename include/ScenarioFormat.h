@@ -0,0 +1,98 @@
+#include <array>   // for std::array
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint8_t, std::uint32_t, std::uint64_t
+
+#ifndef SCENARIO_FORMAT_H
+#define SCENARIO_FORMAT_H
+
+// the layout of a compiled scenario (tools/scenario compiles
+// them from text, see scenarios/classic.txt)
+//
+//   header:       Header, "MCSC", version and the count of every section
+//   buildings:    Building[buildingCount]
+//   launch sites: LaunchSite[launchSiteCount]
+//   waves:        Wave[waveCount]
+//
+// everything is little-endian and sits at its natural
+// alignment, so a mapped file is used as these structs in place
+// (see ScenarioView), nothing is parsed or copied to load it.
+// the sections follow each other without any gaps.
+namespace ScenarioFormat
+{
+    constexpr std::array<std::uint8_t, 4> magic{'M', 'C', 'S', 'C'};
+    constexpr std::uint32_t version{1};
+
+    // Header::flags
+    // the scenario picks the game's seed
+    constexpr std::uint32_t hasSeed{1u << 0};
+
+    struct Header
+    {
+        std::array<std::uint8_t, 4> magic{};
+        std::uint32_t version{};
+        std::uint64_t seed{};
+        std::uint32_t flags{};
+        std::uint32_t buildingCount{};
+        std::uint32_t launchSiteCount{};
+        std::uint32_t waveCount{};
+    };
+
+    // how far a building may be off the ground or past the sides
+    // of the world, so rounding y + height or x + width doesn't
+    // reject it. the world stands it right on the ground
+    constexpr float fitTolerance{0.01f};
+
+    // a building standing on the ground from the start
+    struct Building
+    {
+        float x{};
+        float y{};
+        float width{};
+        float height{};
+        std::array<std::uint8_t, 4> tint{};
+    };
+
+    // where enemy missiles come from: anywhere between
+    // minX and maxX at height y, every site as likely
+    struct LaunchSite
+    {
+        float minX{};
+        float maxX{};
+        float y{};
+    };
+
+    // Wave::flags
+    // the next wave waits until the sky is clear of missiles
+    constexpr std::uint32_t waitForClearSky{1u << 0};
+
+    // the most missiles one wave may send. the director
+    // schedules every launch of a wave up front, and no
+    // world holds this many missiles anyway
+    constexpr std::uint32_t maxWaveCount{65536};
+
+    // the longest a wave may wait or space its launches, an hour
+    constexpr float maxWaveSeconds{3600.0f};
+
+    // delaySeconds after the previous wave, count missiles,
+    // perLaunch at a time every spacingSeconds
+    struct Wave
+    {
+        float delaySeconds{};
+        std::uint32_t count{};
+        float spacingSeconds{};
+        std::uint32_t perLaunch{};
+        std::uint32_t flags{};
+    };
+
+    // the sizes the structs have in the file, a compiler
+    // that pads them differently can't use it in place
+    static_assert(sizeof(Header) == 32 && alignof(Header) == 8);
+    static_assert(sizeof(Building) == 20 && alignof(Building) == 4);
+    static_assert(sizeof(LaunchSite) == 12 && alignof(LaunchSite) == 4);
+    static_assert(sizeof(Wave) == 20 && alignof(Wave) == 4);
+
+    // the alignment the bytes of a scenario have to start at
+    constexpr std::size_t alignment{alignof(Header)};
+}
+
+#endif
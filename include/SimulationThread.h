@@ -0,0 +1,88 @@
+#include "World.h"
+#include "InputFrame.h"
+#include "FixedTimestep.h"
+#include "RenderSnapshot.h"
+#include "TripleBuffer.h"
+#include "SpscQueue.h"
+#include "ReplayRecorder.h"
+#include "WaveDirector.h"
+#include <atomic>       // for std::atomic
+#include <thread>       // for std::jthread
+#include <stop_token>   // for std::stop_token
+
+#ifndef SIMULATION_THREAD_H
+#define SIMULATION_THREAD_H
+
+// steps a world on its own thread at a fixed tick rate
+// so a slow frame never holds the simulation back
+// (and a slow tick never holds a frame back).
+// the drawing thread talks to it through two lock-free channels:
+// inputs go in through a queue, snapshots of the world come
+// out through a triple buffer. nothing else is shared.
+class SimulationThread
+{
+public:
+    SimulationThread(const WorldConfig &config, int maxStepsPerFrame);
+
+    SimulationThread(const SimulationThread &) = delete;
+    SimulationThread &operator=(const SimulationThread &) = delete;
+
+    // step the world on jobs, call before start()
+    void setJobSystem(JobSystem *jobs);
+
+    // record every tick into recorder, call before start()
+    // recorder isn't owned and has to outlive the thread
+    void setRecorder(ReplayRecorder *recorder);
+
+    // let director launch the enemies, call before start()
+    // it's updated on the simulation thread before every tick.
+    // director isn't owned and has to outlive the thread
+    void setWaveDirector(WaveDirector *director);
+
+    // the memory the world's entities hold, call before start()
+    WorldMemory getWorldMemory() const;
+
+    // start stepping the world
+    void start();
+
+    // stop stepping and wait for the thread to finish
+    // also done by the destructor
+    void stop();
+
+    // drawing thread only
+    // queue an input for the next tick, every tick picks up
+    // at most one, returns false if the queue is full
+    bool pushInput(const InputFrame &input);
+
+    // drawing thread only
+    // the newest snapshot the simulation has published
+    // it stays valid until the next call
+    const RenderSnapshot &acquireSnapshot();
+
+    // ticks thrown away because the thread couldn't keep up
+    long long getDroppedTicks() const;
+
+    // seconds on the clock both threads agree on
+    static double getTime();
+
+private:
+    void run(std::stop_token stopToken);
+
+    void publishSnapshot(double tickTime);
+
+    World m_world;
+    FixedTimestep m_timestep;
+
+    SpscQueue<InputFrame, 64> m_inputs{};
+    TripleBuffer<RenderSnapshot> m_snapshots{};
+
+    std::atomic<long long> m_droppedTicks{};
+
+    ReplayRecorder *m_recorder{};
+    WaveDirector *m_director{};
+
+    // last, so it's joined before anything it uses is destroyed
+    std::jthread m_thread{};
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include "SlotMap.h"
+#include "ByteStream.h"
+#include "Sweep.h"
+#include <raylib.h>
+#include <vector>  // for std::vector
+#include <cstddef> // for std::size_t
+
+#ifndef SKYLINE_H
+#define SKYLINE_H
+
+// the city seen as a row of columns standing on the ground
+// every column remembers how high the city is there and
+// which building that height belongs to, so asking
+// "did this point hit a building?" is one array lookup
+// no matter how many buildings there are.
+class Skyline
+{
+public:
+    // room for maxBuildings buildings is reserved up front
+    Skyline(float width, float groundY, float columnWidth, std::size_t maxBuildings);
+
+    // raise the columns under a building to its roof
+    // where two buildings are as high the one in the
+    // lower slot owns the column, whatever the order
+    // they were added or removed in
+    void addBuilding(const Handle &building, const Rectangle &rectangle);
+
+    // flatten the columns a building owned, then let the
+    // remaining buildings that share those columns stamp
+    // themselves back in. only the buildings near it are
+    // looked at, not the whole city
+    void removeBuilding(const Handle &building, const Rectangle &rectangle);
+
+    // the building under point, or an invalid handle
+    // if the point is above the skyline
+    Handle getBuildingAt(const Vector2 &point) const;
+
+    // the first building a point moving from -> to runs into,
+    // or an invalid handle if it gets through. impact is set
+    // to how far along the way (0 to 1) it hits, see Sweep.h.
+    // only the columns between from.x and to.x are looked at
+    Handle sweep(const Vector2 &from, const Vector2 &to, float &impact) const;
+
+    std::size_t getColumnCount() const;
+    float getColumnWidth() const;
+
+    // how far column rises above the ground
+    float getColumnHeight(std::size_t column) const;
+
+    void clear();
+
+    // blit the columns and footprints into writer / back from
+    // reader. restoring needs a skyline with the same columns
+    void saveState(ByteWriter &writer) const;
+    bool restoreState(ByteReader &reader);
+
+private:
+    std::size_t getColumn(float x) const;
+
+    // the columns covering [x, x + width)
+    std::size_t getFirstColumn(const Rectangle &rectangle) const;
+    std::size_t getLastColumn(const Rectangle &rectangle) const;
+
+    void stamp(const Handle &building, const Rectangle &rectangle, std::size_t first, std::size_t last);
+
+    // sort the footprints by their left edge if buildings
+    // were added since the last time
+    void sortFootprints();
+
+    float m_groundY{};
+    float m_columnWidth{};
+
+    std::vector<float> m_heights{};
+    std::vector<Handle> m_owners{};
+
+    // every building added since clear(), the removed ones with
+    // an invalid handle. sorted by left edge the buildings that
+    // can share a column with one are those starting less than
+    // m_widest to the left of it and before its right edge
+    struct Footprint
+    {
+        Rectangle rectangle{};
+        Handle building{};
+    };
+
+    std::vector<Footprint> m_footprints{};
+    float m_widest{};
+    bool m_isSorted{true};
+
+    // at least as high as the highest column, so sweep()
+    // can skip anything flying above the whole city
+    // (it isn't lowered when buildings go, only by clear())
+    float m_tallest{};
+};
+
+#endif
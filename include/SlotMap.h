@@ -0,0 +1,87 @@
+#include "ByteStream.h"
+#include <vector>  // for std::vector
+#include <span>    // for std::span
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint32_t
+
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+// a stable reference to an entity inside a pool
+// the generation tells a handle to a despawned entity
+// apart from a handle to whatever reused its slot
+struct Handle
+{
+    static constexpr std::uint32_t invalidSlot{0xFFFFFFFFu};
+
+    std::uint32_t slot{invalidSlot};
+    std::uint32_t generation{};
+
+    bool isValid() const { return slot != invalidSlot; }
+
+    friend bool operator==(const Handle &, const Handle &) = default;
+};
+
+// keeps track of which handle lives at which dense index
+// it doesn't store any entity itself, the owner keeps its
+// entities in dense arrays and mirrors every swap done here.
+// every array is sized once for the capacity, so spawning
+// and despawning never touch the heap.
+class SlotMap
+{
+public:
+    explicit SlotMap(std::size_t capacity);
+
+    std::size_t getCapacity() const;
+    std::size_t size() const;
+
+    // heap memory held by the map
+    std::size_t getReservedBytes() const;
+    bool full() const;
+
+    // hand out a handle for a new entity placed at dense index size() - 1
+    // returns an invalid handle if the map is full
+    Handle insert();
+
+    // the dense index of handle, or npos if it was despawned
+    std::size_t find(const Handle &handle) const;
+
+    // the handle of the entity at a dense index
+    Handle getHandle(std::size_t index) const;
+
+    bool contains(const Handle &handle) const;
+
+    // remove the entity at a dense index
+    // the last entity is moved into index, the owner must do the same
+    void eraseAt(std::size_t index);
+
+    // remove every entity whose dead flag is set, in one pass
+    // survivors keep their relative order and slide down,
+    // the owner must slide its own arrays the same way
+    void compact(std::span<const std::uint8_t> dead);
+
+    void clear();
+
+    // blit the whole map into writer / back from reader
+    // restoring needs a map of the same capacity and
+    // returns false (leaving the map unusable) otherwise
+    void saveState(ByteWriter &writer) const;
+    bool restoreState(ByteReader &reader);
+
+    static constexpr std::size_t npos{static_cast<std::size_t>(-1)};
+
+private:
+    // per slot: current generation and dense index
+    std::vector<std::uint32_t> m_generations{};
+    std::vector<std::uint32_t> m_denseIndex{};
+
+    // per dense index: the slot that owns it
+    std::vector<std::uint32_t> m_slots{};
+
+    // slots waiting to be reused, used as a stack
+    std::vector<std::uint32_t> m_freeSlots{};
+
+    std::size_t m_size{};
+};
+
+#endif
@@ -0,0 +1,158 @@
+#include <raylib.h>
+#include <vector>  // for std::vector
+#include <span>    // for std::span
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::uint32_t, std::uint64_t
+#include <cmath>   // for std::floor, std::fabs
+
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+// a uniform grid broadphase
+// every item is inserted into each cell its bounds overlap,
+// so a point query only has to look at the one cell
+// the point falls in to find every item that might contain it.
+// rebuilding keeps its memory, so a grid rebuilt every tick
+// stops allocating once it has seen its biggest tick.
+class SpatialGrid
+{
+public:
+    SpatialGrid(float width, float height, float cellSize);
+
+    // changes the cell size and empties the grid
+    void setCellSize(float cellSize);
+    float getCellSize() const;
+
+    // forget every inserted item
+    void clear();
+
+    // room for this many item-cell pairs up front,
+    // so a grid of a known biggest size never allocates
+    void reserve(std::size_t entries);
+
+    // add an item covering bounds
+    // items only become visible to query() after build()
+    void insert(std::uint32_t id, const Rectangle &bounds);
+
+    // sort the inserted items into their cells
+    void build();
+
+    // every item sharing the point's cell
+    // these are candidates only, the caller still does
+    // the exact (narrow-phase) test
+    std::span<const std::uint32_t> query(const Vector2 &point);
+
+    // same as query() but without counting the candidates,
+    // so it's safe to call from several threads at once
+    // the caller adds them up with addCandidatePairs()
+    std::span<const std::uint32_t> find(const Vector2 &point) const;
+    void addCandidatePairs(std::uint64_t pairs);
+
+    // items(ids) for every cell the segment from -> to passes
+    // through, in order from from to to, for anything moving.
+    // an item in several of those cells comes up once per cell.
+    // like find() it doesn't count, it returns how many
+    // candidates it handed out
+    template <typename Function>
+    std::uint64_t findAlong(const Vector2 &from, const Vector2 &to, Function &&items) const
+    {
+        // walk the cell coordinates (outside the grid too, clamped
+        // when looked up) one cell border crossing at a time
+        auto column{static_cast<long long>(std::floor(from.x / m_cellSize))};
+        auto row{static_cast<long long>(std::floor(from.y / m_cellSize))};
+        const auto lastColumn{static_cast<long long>(std::floor(to.x / m_cellSize))};
+        const auto lastRow{static_cast<long long>(std::floor(to.y / m_cellSize))};
+
+        const float dx{to.x - from.x};
+        const float dy{to.y - from.y};
+        const long long stepColumn{dx < 0.0f ? -1 : 1};
+        const long long stepRow{dy < 0.0f ? -1 : 1};
+
+        // how far along the segment the next column and row
+        // borders are, and how far apart they are
+        const float columnDelta{dx != 0.0f ? m_cellSize / std::fabs(dx) : 0.0f};
+        const float rowDelta{dy != 0.0f ? m_cellSize / std::fabs(dy) : 0.0f};
+        float nextColumn{dx != 0.0f ? ((static_cast<float>(column) + (dx > 0.0f ? 1.0f : 0.0f)) * m_cellSize - from.x) / dx : 0.0f};
+        float nextRow{dy != 0.0f ? ((static_cast<float>(row) + (dy > 0.0f ? 1.0f : 0.0f)) * m_cellSize - from.y) / dy : 0.0f};
+
+        std::uint64_t candidates{0};
+        std::size_t lastCell{m_cellStart.size()};
+
+        while (true)
+        {
+            // cells outside the grid are the border cells,
+            // several of them in a row are only looked at once
+            const std::size_t cell{clampRow(row) * m_columns + clampColumn(column)};
+
+            if (cell != lastCell)
+            {
+                const std::uint32_t first{m_cellStart[cell]};
+                const std::uint32_t last{m_cellStart[cell + 1]};
+
+                candidates += last - first;
+                items(std::span<const std::uint32_t>{m_cellItems.data() + first, last - first});
+
+                lastCell = cell;
+            }
+
+            const bool isColumnDone{column == lastColumn};
+            const bool isRowDone{row == lastRow};
+
+            if (isColumnDone && isRowDone)
+                break;
+
+            // cross whichever border comes first, rounding
+            // can't make the walk miss the last cell this way
+            if (isRowDone || (!isColumnDone && nextColumn < nextRow))
+            {
+                column += stepColumn;
+                nextColumn += columnDelta;
+            }
+            else
+            {
+                row += stepRow;
+                nextRow += rowDelta;
+            }
+        }
+
+        return candidates;
+    }
+
+    // number of candidates handed out by query()
+    // since the last resetCandidatePairs()
+    std::uint64_t getCandidatePairs() const;
+    void resetCandidatePairs();
+
+private:
+    std::size_t getColumn(float x) const;
+    std::size_t getRow(float y) const;
+
+    // a cell coordinate, kept inside the grid
+    std::size_t clampColumn(long long column) const;
+    std::size_t clampRow(long long row) const;
+
+    float m_width{};
+    float m_height{};
+    float m_cellSize{};
+
+    std::size_t m_columns{};
+    std::size_t m_rows{};
+
+    // (cell, id) pairs in insertion order
+    struct Entry
+    {
+        std::uint32_t cell{};
+        std::uint32_t id{};
+    };
+
+    std::vector<Entry> m_entries{};
+
+    // m_cellItems[m_cellStart[cell] .. m_cellStart[cell + 1]]
+    // are the ids inside the cell
+    std::vector<std::uint32_t> m_cellStart{};
+    std::vector<std::uint32_t> m_cellItems{};
+
+    std::uint64_t m_candidatePairs{};
+};
+
+#endif
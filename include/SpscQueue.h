@@ -0,0 +1,57 @@
+#include <array>   // for std::array
+#include <atomic>  // for std::atomic
+#include <cstddef> // for std::size_t
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+// a fixed-size ring buffer for exactly one producer thread
+// and one consumer thread.
+// push() and pop() finish in a bounded number of steps
+// no matter what the other thread is doing (wait-free):
+// a full queue refuses the push, an empty one the pop.
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // producer only, returns false if the queue is full
+    bool push(const T &item)
+    {
+        const std::size_t tail{m_tail.load(std::memory_order_relaxed)};
+
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity)
+            return false;
+
+        m_items[tail & (Capacity - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // consumer only, returns false if the queue is empty
+    bool pop(T &item)
+    {
+        const std::size_t head{m_head.load(std::memory_order_relaxed)};
+
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+
+        item = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> m_items{};
+
+    // both counters only ever grow, the slot is counter % Capacity
+    // they sit on their own cache lines so the two threads
+    // don't keep stealing the same line from each other
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+};
+
+#endif
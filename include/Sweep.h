@@ -0,0 +1,27 @@
+#include <raylib.h>
+#include <optional> // for std::optional
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+// continuous collision tests for a point moving in a straight
+// line from one tick's position to the next one's.
+// a point test only sees where a fast missile ends up, and
+// can step right over anything thinner than one tick of its
+// flight; these look at the whole way in between.
+// every test returns the time of impact: how far along the
+// way (0 = from, 1 = to) the point first touches the shape,
+// or nothing if it doesn't touch it at all.
+namespace Sweep
+{
+    // the point against a rectangle that stays where it is
+    std::optional<float> segmentRectangle(const Vector2 &from, const Vector2 &to, const Rectangle &rectangle);
+
+    // the point against a circle whose radius goes from
+    // startRadius to endRadius over the same time, like an
+    // explosion growing (or shrinking) during the tick
+    std::optional<float> segmentExpandingCircle(const Vector2 &from, const Vector2 &to,
+                                                const Vector2 &center, float startRadius, float endRadius);
+}
+
+#endif
@@ -0,0 +1,199 @@
+#include <array>     // for std::array
+#include <vector>    // for std::vector
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint32_t, std::uint64_t
+#include <limits>    // for std::numeric_limits
+#include <utility>   // for std::move
+#include <algorithm> // for std::max
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+// items that are due on some tick in the future
+// a hierarchical timing wheel: 4 wheels of 64 slots, the first
+// one a slot per tick, every next one a slot per whole turn
+// of the one below it. an item goes into the slot of the
+// coarsest wheel its tick is still in the future of, and is
+// moved down a wheel each time the wheel below comes round
+// to it. scheduling is O(1) and a tick only ever touches the
+// slots it lands on, no matter how many items are pending.
+// items more than 2^24 ticks ahead wait in an overflow list
+// that is looked at once every 2^24 ticks.
+// the items live in one array with a free list, reserved for
+// capacity, so up to that many pending items never allocate.
+template <typename T>
+class TimerWheel
+{
+public:
+    explicit TimerWheel(std::size_t capacity = 0)
+    {
+        m_nodes.reserve(capacity);
+    }
+
+    // the tick the wheel is at, everything due on
+    // or before it has been handed out already
+    std::uint64_t getNow() const { return m_now; }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    // make room for count more pending items up front
+    // still grows by doubling, so reserving a little
+    // at a time doesn't reallocate every time
+    void reserve(std::size_t count)
+    {
+        const std::size_t needed{m_size + count};
+
+        if (needed > m_nodes.capacity())
+            m_nodes.reserve(std::max(needed, m_nodes.capacity() * 2));
+    }
+
+    // hand item out on tick, which has to be after getNow()
+    // an item due earlier is handed out on the next tick
+    void schedule(std::uint64_t tick, T item)
+    {
+        std::uint32_t node{m_free};
+
+        if (node != npos)
+            m_free = m_nodes[node].next;
+        else
+        {
+            node = static_cast<std::uint32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+
+        m_nodes[node].tick = tick > m_now ? tick : m_now + 1;
+        m_nodes[node].item = std::move(item);
+
+        insert(node);
+        ++m_size;
+    }
+
+    // move on by one tick and call due(item) for every item
+    // scheduled on it. the order isn't the order they were
+    // scheduled in, but it's the same every time.
+    // due may schedule new items (for later ticks)
+    template <typename Function>
+    void advance(Function &&due)
+    {
+        ++m_now;
+
+        // bring the items of the coarser wheels down once the
+        // finer ones come round to them, coarsest first so an
+        // item can drop through several wheels in one go
+        if ((m_now & wheelMask(wheels)) == 0)
+            cascade(m_overflow);
+
+        for (std::size_t wheel{wheels - 1}; wheel > 0; --wheel)
+        {
+            if ((m_now & wheelMask(wheel)) == 0)
+                cascade(m_wheels[wheel][(m_now >> (wheel * slotBits)) & slotMask]);
+        }
+
+        // everything in this slot is due right now
+        Slot &slot{m_wheels[0][m_now & slotMask]};
+        std::uint32_t node{slot.head};
+        slot = Slot{};
+
+        while (node != npos)
+        {
+            const std::uint32_t next{m_nodes[node].next};
+            T item{std::move(m_nodes[node].item)};
+
+            // freed before due() runs, so it can reuse the node
+            m_nodes[node].next = m_free;
+            m_free = node;
+            --m_size;
+
+            due(item);
+
+            node = next;
+        }
+    }
+
+private:
+    static constexpr std::uint32_t npos{std::numeric_limits<std::uint32_t>::max()};
+
+    static constexpr std::size_t wheels{4};
+    static constexpr std::size_t slotBits{6};
+    static constexpr std::size_t slots{std::size_t{1} << slotBits};
+    static constexpr std::uint64_t slotMask{slots - 1};
+
+    // the bits of a tick below wheel
+    static constexpr std::uint64_t wheelMask(std::size_t wheel)
+    {
+        return (std::uint64_t{1} << (wheel * slotBits)) - 1;
+    }
+
+    struct Node
+    {
+        std::uint64_t tick{};
+        std::uint32_t next{npos};
+        T item{};
+    };
+
+    // a linked list of nodes, items are appended
+    // at the tail so a slot keeps them in order
+    struct Slot
+    {
+        std::uint32_t head{npos};
+        std::uint32_t tail{npos};
+    };
+
+    void append(Slot &slot, std::uint32_t node)
+    {
+        m_nodes[node].next = npos;
+
+        if (slot.tail == npos)
+            slot.head = node;
+        else
+            m_nodes[slot.tail].next = node;
+
+        slot.tail = node;
+    }
+
+    void insert(std::uint32_t node)
+    {
+        const std::uint64_t tick{m_nodes[node].tick};
+
+        // the first wheel whose turn tick is in, counting
+        // from the bits it has in common with now
+        const std::uint64_t differs{tick ^ m_now};
+
+        for (std::size_t wheel{0}; wheel < wheels; ++wheel)
+        {
+            if (differs <= wheelMask(wheel + 1))
+            {
+                append(m_wheels[wheel][(tick >> (wheel * slotBits)) & slotMask], node);
+                return;
+            }
+        }
+
+        append(m_overflow, node);
+    }
+
+    // put every item of slot where it belongs now
+    void cascade(Slot &slot)
+    {
+        std::uint32_t node{slot.head};
+        slot = Slot{};
+
+        while (node != npos)
+        {
+            const std::uint32_t next{m_nodes[node].next};
+            insert(node);
+            node = next;
+        }
+    }
+
+    std::vector<Node> m_nodes{};
+    std::uint32_t m_free{npos};
+    std::size_t m_size{};
+
+    std::array<std::array<Slot, slots>, wheels> m_wheels{};
+    Slot m_overflow{};
+
+    std::uint64_t m_now{};
+};
+
+#endif
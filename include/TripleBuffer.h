@@ -0,0 +1,60 @@
+#include <array>   // for std::array
+#include <atomic>  // for std::atomic
+#include <cstdint> // for std::uint8_t
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+// hands whole values from one writer thread to one reader thread
+// without locks and without either side ever waiting.
+// the writer fills the back buffer and publishes it, the reader
+// picks up the most recently published one. a buffer that is
+// being written or read is never touched by the other side,
+// and snapshots the reader was too slow to see are skipped.
+template <typename T>
+class TripleBuffer
+{
+public:
+    // the buffer the writer may fill
+    T &getWriteBuffer() { return m_buffers[m_back]; }
+
+    // hand the write buffer over to the reader
+    void publish()
+    {
+        // swap our back buffer with the middle one
+        // and flag the middle one as new
+        m_back = m_middle.exchange(static_cast<std::uint8_t>(m_back | newFlag), std::memory_order_acq_rel) & indexMask;
+    }
+
+    // pick up the newest published buffer
+    // returns false (and keeps the current one) if
+    // nothing was published since the last call
+    bool acquire()
+    {
+        if (!(m_middle.load(std::memory_order_acquire) & newFlag))
+            return false;
+
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & indexMask;
+        return true;
+    }
+
+    // the buffer the reader may look at
+    const T &getReadBuffer() const { return m_buffers[m_front]; }
+
+private:
+    static constexpr std::uint8_t indexMask{0x3};
+    static constexpr std::uint8_t newFlag{0x4};
+
+    std::array<T, 3> m_buffers{};
+
+    // only touched by the writer
+    std::uint8_t m_back{0};
+
+    // shared, the index of the middle buffer plus the new flag
+    std::atomic<std::uint8_t> m_middle{1};
+
+    // only touched by the reader
+    std::uint8_t m_front{2};
+};
+
+#endif
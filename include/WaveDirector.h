@@ -0,0 +1,227 @@
+#include "World.h"
+#include "TimerWheel.h"
+#include "Random.h"
+#include "ScenarioFormat.h"
+#include <vector>     // for std::vector
+#include <span>       // for std::span
+#include <coroutine>  // for std::coroutine_handle, std::suspend_always
+#include <exception>  // for std::terminate
+#include <cstddef>    // for std::size_t
+#include <cstdint>    // for std::uint32_t, std::uint64_t
+
+#ifndef WAVE_DIRECTOR_H
+#define WAVE_DIRECTOR_H
+
+// a script of enemy waves, written as a coroutine that
+// co_awaits the delays, bursts and conditions of a
+// WaveDirector, for example
+//
+//   WaveScript twoWaves(WaveDirector &director)
+//   {
+//       co_await director.burst(10, director.toTicks(0.5f));
+//       co_await director.until([](const World &world) { return world.getMissiles(Faction::enemy).empty(); });
+//       co_await director.waitSeconds(2.0f);
+//       co_await director.burst(20, director.toTicks(0.25f));
+//   }
+//
+// it does nothing until it's handed to WaveDirector::start()
+class WaveScript
+{
+public:
+    struct promise_type
+    {
+        WaveScript get_return_object() { return WaveScript{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+
+        void return_void() {}
+
+        // a script has nothing to throw, the game can't go on without it
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit WaveScript(std::coroutine_handle<promise_type> handle);
+    ~WaveScript();
+
+    WaveScript(WaveScript &&other) noexcept;
+    WaveScript &operator=(WaveScript &&other) noexcept;
+
+    WaveScript(const WaveScript &) = delete;
+    WaveScript &operator=(const WaveScript &) = delete;
+
+    // ran to its end
+    bool isDone() const;
+
+private:
+    friend class WaveDirector;
+
+    std::coroutine_handle<promise_type> m_handle{};
+};
+
+// runs wave scripts against a world and decides how many
+// enemy missiles it launches on every tick.
+// the director only ever looks at the world, what it decides
+// goes in through InputFrame::enemies like a click, so a
+// replay holds every launch and plays back without it, and
+// a saved world doesn't have to know about coroutines.
+// build the world with WorldTuning::spawnIntervalSeconds at 0
+// to have the director send every enemy.
+//
+// delays and bursts go on a timer wheel, so any number of
+// pending launches costs the same per tick. conditions are
+// checked once per tick each, keep them cheap.
+class WaveDirector
+{
+public:
+    // seed the scripts' random numbers, the same seed
+    // and the same world make the same waves
+    WaveDirector(float tickRate, std::uint64_t seed);
+
+    WaveDirector(const WaveDirector &) = delete;
+    WaveDirector &operator=(const WaveDirector &) = delete;
+
+    // run script from the next update() on
+    // the director owns it from now on
+    void start(WaveScript script);
+
+    // call once before every world.step()
+    // runs every script that is due and returns how many
+    // enemy missiles to launch on the tick, which belongs
+    // in that step's InputFrame::enemies
+    std::uint32_t update(const World &world);
+
+    // every script ran to its end
+    bool isDone() const;
+
+    // ticks updated so far
+    std::uint64_t getTick() const;
+
+    std::uint64_t toTicks(float seconds) const;
+
+    // for scripts: random numbers that are the
+    // same every time for the same seed
+    Random::Pcg32 &getRng();
+
+    // for scripts: the world being updated
+    const World &getWorld() const;
+
+    // launch count enemy missiles on this tick
+    void launch(std::uint32_t count);
+
+    struct Delay
+    {
+        WaveDirector &director;
+        std::uint64_t ticks{};
+
+        bool await_ready() const { return ticks == 0; }
+        void await_suspend(std::coroutine_handle<> script) { director.schedule(ticks, Event{script, 0}); }
+        void await_resume() const {}
+    };
+
+    // co_await to carry on ticks (or seconds) from now
+    Delay wait(std::uint64_t ticks);
+    Delay waitSeconds(float seconds);
+
+    struct Burst
+    {
+        WaveDirector &director;
+        std::uint32_t count{};
+        std::uint64_t spacing{};
+        std::uint32_t perLaunch{};
+
+        bool await_ready() const { return count == 0; }
+        bool await_suspend(std::coroutine_handle<> script) { return director.scheduleBurst(*this, script); }
+        void await_resume() const {}
+    };
+
+    // co_await to launch count missiles, perLaunch at a time
+    // every spacing ticks, starting right now. the script
+    // carries on with the last launch.
+    // every launch is put on the timer wheel in one go, room
+    // for all of them is made before the first one
+    Burst burst(std::uint32_t count, std::uint64_t spacing, std::uint32_t perLaunch = 1);
+
+    template <typename Predicate>
+    struct Until
+    {
+        WaveDirector &director;
+        Predicate predicate;
+
+        bool await_ready() const { return predicate(director.getWorld()); }
+
+        void await_suspend(std::coroutine_handle<> script)
+        {
+            director.m_conditions.push_back(Condition{this, [](const void *awaiter, const World &world)
+                                                      { return static_cast<const Until *>(awaiter)->predicate(world); },
+                                                      script});
+        }
+
+        void await_resume() const {}
+    };
+
+    // co_await to carry on once predicate(world) is true,
+    // checked on every update() from the next one on
+    template <typename Predicate>
+    Until<Predicate> until(Predicate predicate)
+    {
+        return Until<Predicate>{*this, predicate};
+    }
+
+private:
+    // what the timer wheel hands out: a script to
+    // resume or missiles to launch, or both
+    struct Event
+    {
+        std::coroutine_handle<> script{};
+        std::uint32_t launches{};
+    };
+
+    // a script waiting on a condition, check() asks
+    // the awaiter in the suspended script's frame
+    struct Condition
+    {
+        const void *awaiter{};
+        bool (*check)(const void *awaiter, const World &world){};
+        std::coroutine_handle<> script{};
+    };
+
+    void schedule(std::uint64_t ticks, const Event &event);
+    // returns false if the whole burst went out right
+    // now and script can simply carry on
+    bool scheduleBurst(const Burst &burst, std::coroutine_handle<> script);
+
+    void resume(std::coroutine_handle<> script);
+
+    float m_tickRate{};
+    Random::Pcg32 m_rng;
+
+    std::vector<WaveScript> m_scripts{};
+
+    // scripts started since the last update()
+    std::vector<std::coroutine_handle<>> m_starting{};
+
+    TimerWheel<Event> m_timers;
+
+    // scratch for update(): the scripts due on
+    // this tick, in the order they're resumed in
+    std::vector<std::coroutine_handle<>> m_due{};
+
+    std::vector<Condition> m_conditions{};
+    std::vector<Condition> m_checking{};
+
+    // the world of the running update()
+    const World *m_world{};
+
+    std::uint32_t m_launches{};
+};
+
+// the waves of the game: bursts that get longer and
+// faster, each one once the sky is clear of the last
+WaveScript campaignWaves(WaveDirector &director);
+
+// the waves of a scenario, one after the other, read straight
+// out of its bytes (which have to outlive the script)
+WaveScript scenarioWaves(WaveDirector &director, std::span<const ScenarioFormat::Wave> waves);
+
+#endif
@@ -0,0 +1,455 @@
+#include "Rectangle2D.h"
+#include "Explosion.h"
+#include "Missile.h"
+#include "MissileStore.h"
+#include "InputFrame.h"
+#include "SpatialGrid.h"
+#include "CoverageMap.h"
+#include "Pool.h"
+#include "CommandBuffer.h"
+#include "Skyline.h"
+#include "RenderSnapshot.h"
+#include "JobSystem.h"
+#include "Random.h"
+#include "ByteStream.h"
+#include "InterceptSolver.h"
+#include "ScenarioFormat.h"
+#include <vector>       // for std::vector
+#include <cstdint>      // for std::uint64_t
+#include <cstddef>      // for std::size_t
+#include <span>         // for std::span
+#include <optional>     // for std::optional
+
+#ifndef WORLD_H
+#define WORLD_H
+
+// the numbers that decide how hard the game is
+// all of them were found by trial and error, tools/balance
+// plays thousands of games to find better ones.
+// speeds and radii are per tick at 60 ticks per second,
+// the world scales them to its own tick rate
+struct WorldTuning
+{
+    // how much faster a missile gets every tick
+    float enemyMissileSpeed{0.01f};
+    float playerMissileSpeed{1.0f};
+
+    // the most any missile moves in one tick
+    float missileTopSpeed{100.0f};
+
+    // seconds between two enemy missiles
+    // 0 turns the steady trickle off, for games where
+    // a WaveDirector sends every enemy
+    float spawnIntervalSeconds{2.0f};
+
+    // an explosion starts at the smallest radius, grows
+    // to the biggest, shrinks back and is gone
+    float minExplosionRadius{5.0f};
+    float maxExplosionRadius{20.0f};
+
+    // the city: big buildings in the middle and
+    // as many small ones on either side of them
+    int bigBuildings{3};
+    int smallBuildings{3};
+    float bigBuildingSize{80.0f};
+    float smallBuildingSize{40.0f};
+};
+
+// what happened so far, for headless tools
+// that want to know how well a game went
+struct WorldStats
+{
+    std::uint64_t enemyMissilesSpawned{};
+    std::uint64_t enemyMissilesIntercepted{};
+    std::uint64_t playerMissilesFired{};
+    std::uint64_t buildingsLost{};
+};
+
+// the heap memory every kind of entity holds
+// its containers are reserved up front and never
+// shrink, so this is also the most they ever held
+struct WorldMemory
+{
+    std::size_t playerMissiles{};
+    std::size_t enemyMissiles{};
+    std::size_t explosions{};
+    std::size_t buildings{};
+};
+
+// batteries that pick and shoot down incoming
+// missiles on their own, next to the player's clicks
+struct AutoDefenseConfig
+{
+    // off unless asked for, the player aims every missile
+    bool enabled{false};
+
+    // spread evenly along the ground, the first one
+    // stands where the player fires from
+    int batteries{3};
+
+    // seconds between two shots of one battery
+    float reloadSeconds{0.5f};
+
+    // how many (threat, battery) intercepts may be solved per
+    // tick, the most urgent threats get solved first.
+    // a count and not a time, so a replay fires
+    // the very same shots on any machine
+    int solveBudget{4096};
+};
+
+// everything needed to build a world
+// a world never asks the window for its size,
+// so it can run without one
+struct WorldConfig
+{
+    float width{800.0f};
+    float height{450.0f};
+
+    // same seed + same inputs = same game
+    std::uint64_t seed{};
+
+    // how many times step() is called per second of game time
+    // every speed is scaled by it, so the game plays the same
+    // at any tick rate
+    float tickRate{60.0f};
+
+    // size of a collision grid cell
+    // roughly the diameter of the biggest explosion works well
+    float collisionCellSize{40.0f};
+
+    // width of a skyline column
+    // 1 means one column per pixel
+    float skylineColumnWidth{1.0f};
+
+    // fixed capacities of the entity pools
+    // anything spawned past these is dropped.
+    // player and enemy missiles get maxMissiles each
+    std::size_t maxMissiles{4096};
+    std::size_t maxExplosions{1024};
+    std::size_t maxBuildings{64};
+
+    WorldTuning tuning{};
+
+    AutoDefenseConfig autoDefense{};
+
+    // a compiled scenario (see Scenario.h) whose buildings and
+    // launch sites replace the built-in city and the launches
+    // anywhere along the top, empty for the built-in game.
+    // the world uses the bytes in place, they have to outlive it
+    // (maxBuildings still has to have room for its buildings)
+    std::span<const std::uint8_t> scenario{};
+};
+
+// the whole game simulation
+// it doesn't call any window, input or drawing function
+// of raylib, so it can be stepped headless as fast as we want
+// and the raylib front end only has to draw what's in here
+class World
+{
+public:
+    explicit World(const WorldConfig &config);
+
+    // a copy is a whole separate world
+    // that shares the job system, if any
+    World(const World &) = default;
+    World &operator=(const World &) = default;
+
+    // advance the simulation by exactly one tick
+    void step(const InputFrame &input);
+
+    // split the per-entity phases of step() across jobs
+    // the world comes out of every tick exactly the same
+    // with or without it. nullptr (the default) steps
+    // everything on the calling thread.
+    // jobs isn't owned and has to outlive its use here
+    void setJobSystem(JobSystem *jobs);
+
+    // the game is over once every building is destroyed
+    bool isOver() const;
+
+    // number of ticks stepped so far
+    std::uint64_t getTick() const;
+
+    // the (fractional) tick to draw missiles at, alpha of the
+    // way from the previous tick's positions to the last ones
+    double getRenderTick(float alpha) const;
+
+    // the radius to draw an explosion with, alpha of the
+    // way from its previous radius to its current one
+    static float getRenderRadius(const Explosion &explosion, float alpha);
+
+    // copy what has to be drawn into snapshot
+    // the vectors of snapshot are reused, so once they
+    // have grown big enough this doesn't allocate
+    void fillSnapshot(RenderSnapshot &snapshot) const;
+
+    float getTickRate() const;
+
+    // the missiles of one faction
+    const MissileStore &getMissiles(Faction faction) const;
+    const Pool<Rectangle2D> &getBuildings() const;
+    const Pool<Explosion> &getExplosions() const;
+    const Skyline &getSkyline() const;
+
+    float getWidth() const;
+    float getHeight() const;
+
+    const WorldStats &getStats() const;
+
+    WorldMemory getMemory() const;
+
+    // where player missiles are launched from
+    Vector2 getLauncherPosition() const;
+
+    // how many ticks a player missile fired on this tick
+    // (from launcher, the player's own by default)
+    // takes to reach target, for anything aiming ahead
+    std::uint64_t getPlayerFlightTicks(const Vector2 &target) const;
+    std::uint64_t getPlayerFlightTicks(const Vector2 &launcher, const Vector2 &target) const;
+
+    // where the auto-defense batteries stand
+    // empty when auto-defense is off
+    const std::vector<Vector2> &getBatteries() const;
+
+    // the whole state of the world as one flat byte buffer
+    // every container is blitted array by array, so saving and
+    // restoring cost a few memcpys, not a walk over every entity.
+    // bytes is cleared first and keeps its memory, so saving
+    // into the same buffer again doesn't allocate.
+    // the bytes are in this machine's byte order and only
+    // meant for the same build (rewind, restarts, forks)
+    void saveState(std::vector<std::uint8_t> &bytes) const;
+
+    // go back to a state saved by saveState()
+    // the world must have been built from the same config
+    // (see readStateConfig()), returns false otherwise.
+    // a buffer that turns out to be broken half way through
+    // also returns false and leaves the world half restored
+    bool restoreState(std::span<const std::uint8_t> bytes);
+
+    // the config of the world a state was saved from
+    // build a World from it to restore the state into
+    static std::optional<WorldConfig> readStateConfig(std::span<const std::uint8_t> bytes);
+
+    // the config as a portable (little-endian) byte sequence
+    static void writeConfig(ByteWriter &writer, const WorldConfig &config);
+    static WorldConfig readConfig(ByteReader &reader);
+
+    const WorldConfig &getConfig() const;
+
+    // a hash of everything that decides how the game goes on
+    // two worlds with the same hash (almost certainly) play
+    // out the same, replays use it to prove a change to the
+    // simulation didn't change what it does
+    std::uint64_t getStateHash() const;
+
+    // how many narrow-phase tests the explosion grid
+    // handed out during the last tick
+    std::uint64_t getCandidatePairs() const;
+
+private:
+    // the benchmarks in bench/ time the phases of step() one by one
+    friend class WorldBench;
+
+    void updateMissiles();
+    void detonateMissiles();
+
+    // queue the player's missile if input fired one
+    void applyInput(const InputFrame &input);
+
+    // queue an enemy missile every spawn interval
+    void spawnEnemies();
+
+    // queue count enemy missiles at once
+    void spawnEnemyMissiles(std::uint32_t count);
+
+    // let every reloaded battery fire at the
+    // most urgent threat it can catch
+    void autoDefend();
+
+    // queue an interceptor from battery at the enemy missile at
+    // index, ahead ticks from now or a little later
+    // returns false if it can't be caught after all
+    bool fireBattery(std::size_t battery, std::size_t missile, std::uint64_t ahead);
+
+    // the threat the enemy missile at index poses is being
+    // taken care of by an interceptor already
+    bool isEngaged(std::size_t missile) const;
+
+    void updateExplosions();
+
+    // grow or shrink the explosions in [first, last)
+    // and mark the ones that are gone
+    void updateExplosions(std::size_t first, std::size_t last);
+
+    // test the missiles in [first, last) of a faction and write
+    // down what each one hit, returns the candidate pairs tested
+    // enemies can hit buildings and explosions, player
+    // missiles only explosions on their way up
+    std::uint64_t collideEnemyMissiles(std::size_t first, std::size_t last);
+    std::uint64_t collidePlayerMissiles(std::size_t first, std::size_t last);
+
+    // whether a missile moving from -> to runs into an explosion
+    // before impact (see Sweep.h), adds the candidates it tested
+    bool sweepExplosions(const Vector2 &from, const Vector2 &to, float impact, std::uint64_t &candidatePairs) const;
+
+    // fn(first, last) over [0, count) on the job system if
+    // there is one, in one go on this thread otherwise
+    template <typename Function>
+    void parallelFor(std::size_t count, std::size_t granularity, Function &&function)
+    {
+        if (m_jobs)
+            m_jobs->parallelFor(count, granularity, function);
+        else if (count > 0)
+            function(std::size_t{0}, count);
+    }
+
+    void setupPlayerMissile(Missile &playerMissile, const Vector2 &launcher, const Vector2 &target) const;
+    void setupEnemyMissile(Missile &enemyMissile);
+
+    void setupBigBuildings();
+    void setupSmallBuildings();
+    void setupScenarioBuildings(std::span<const ScenarioFormat::Building> buildings);
+
+    void placeBuildings(int noOfBuildings, float buildingW, float buildingH, const Color &color, float width, float innerPadding, float outerPadding);
+
+    void applyCollisions();
+
+    // apply every kill and spawn recorded during the tick
+    void applyCommands();
+
+    void rebuildExplosionGrid();
+
+    // what the world was built from
+    WorldConfig m_config{};
+
+    float m_width{};
+    float m_height{};
+    float m_tickRate{};
+
+    // everything was tuned at 60 ticks per second
+    // speeds per tick are multiplied by this to keep
+    // speeds per second the same at other tick rates
+    float m_timeScale{};
+
+    // ticks between two enemy missiles, 0 for none
+    int m_spawnInterval{};
+
+    // where the scenario's enemy missiles come from
+    // straight out of its bytes, empty for anywhere along the top
+    std::span<const ScenarioFormat::LaunchSite> m_launchSites{};
+
+    // every random number of the simulation comes from here
+    // so a seed is all it takes to replay a game
+    Random::Pcg32 m_rng;
+
+    // stores all the shot missiles, one store per faction
+    // one contiguous array per missile property
+    MissileStore m_playerMissiles;
+    MissileStore m_enemyMissiles;
+
+    MissileStore &getMissiles(Faction faction);
+
+    // a pool that will store all the buildings
+    Pool<Rectangle2D> m_buildings;
+
+    // this pool will store all the
+    // explosions caused by player's missiles
+    Pool<Explosion> m_explosions;
+
+    // kills and spawns recorded during a tick
+    // applied all at once by applyCommands()
+    CommandBuffer m_commands;
+
+    // buildings destroyed during the current applyCommands()
+    struct DestroyedBuilding
+    {
+        Handle handle{};
+        Rectangle rectangle{};
+    };
+
+    std::vector<DestroyedBuilding> m_destroyedBuildings{};
+
+    // the buildings seen as columns, so a missile
+    // hitting the city is a single lookup
+    Skyline m_skyline;
+
+    // broadphase grid for the explosions in applyCollisions()
+    // ids are indices into the explosion pool
+    SpatialGrid m_explosionGrid;
+
+    // the cells wholly inside an explosion, rebuilt with the
+    // grid. a missile ending its tick in one of them is caught
+    // without looking at a single explosion
+    CoverageMap m_explosionCoverage;
+
+    // what each missile hit during applyCollisions()
+    // written in parallel, one entry per missile of each
+    // faction, then turned into commands in missile order
+    enum class MissileHit : std::uint8_t
+    {
+        none,
+        building,
+        explosion,
+    };
+
+    std::vector<MissileHit> m_enemyHits{};
+    std::vector<Handle> m_hitBuildings{};
+    std::vector<MissileHit> m_playerHits{};
+
+    // explosions that shrank away during updateExplosions()
+    std::vector<std::uint8_t> m_expiredExplosions{};
+
+    // auto-defense, everything stays empty while it's off
+    std::vector<Vector2> m_batteries{};
+    std::uint64_t m_reloadTicks{};
+
+    // the tick each battery can fire again on
+    std::vector<std::uint64_t> m_batteryReadyTicks{};
+
+    // one per enemy missile slot: the missile of that generation
+    // has an interceptor coming until the tick it should
+    // have been caught on, it's fair game again after that
+    struct Engagement
+    {
+        std::uint32_t generation{};
+        std::uint64_t untilTick{};
+    };
+
+    std::vector<Engagement> m_engagements{};
+
+    // an interceptor recorded this tick, the index of its spawn
+    // in m_commands and the engagement it starts if it's pushed
+    struct PendingEngagement
+    {
+        std::size_t spawn{};
+        Handle target{};
+        std::uint64_t untilTick{};
+    };
+
+    std::vector<PendingEngagement> m_pendingEngagements{};
+
+    // scratch for autoDefend(): enemy missile indices most urgent
+    // first, the batteries that can fire and the ticks ahead
+    // every one of them meets every threat, one row per battery
+    std::vector<std::uint32_t> m_threats{};
+    std::vector<std::size_t> m_readyBatteries{};
+    std::vector<float> m_intercepts{};
+    InterceptSolver m_interceptors;
+
+    JobSystem *m_jobs{};
+
+    // counts the ticks until the next enemy missile
+    int m_spawnCounter{};
+
+    std::uint64_t m_tick{};
+
+    WorldStats m_stats{};
+
+    // goes up whenever the set of buildings changes,
+    // so whoever draws them knows when to redraw
+    // not part of the state, only ever compared for change
+    std::uint64_t m_buildingsVersion{};
+};
+
+#endif
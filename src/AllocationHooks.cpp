@@ -0,0 +1,80 @@
+#include "AllocationTracker.h"
+#include <new>       // for std::bad_alloc, std::align_val_t
+#include <cstdlib>   // for std::malloc, std::free, std::aligned_alloc
+#include <cstddef>   // for std::size_t, std::max_align_t
+#include <cstdint>   // for std::uint32_t, std::uint64_t
+#include <algorithm> // for std::max
+
+// the global operator new and delete, counting every allocation
+// into AllocationTracker. only built with the cmake option
+// MISSILE_COMMANDER_TRACK_ALLOCATIONS, which also links this file
+// into the game; without it this file is empty and the standard
+// library's versions are used
+#if defined(MISSILE_COMMANDER_TRACK_ALLOCATIONS)
+
+namespace
+{
+    // every block starts with what delete needs to know,
+    // padded to the block's alignment so what follows stays aligned
+    struct Header
+    {
+        std::uint64_t size{};
+        std::uint32_t phase{};
+    };
+
+    std::size_t getHeaderSize(std::size_t alignment)
+    {
+        return std::max(alignment, sizeof(Header));
+    }
+
+    void *allocate(std::size_t size, std::size_t alignment)
+    {
+        const std::size_t headerSize{getHeaderSize(alignment)};
+        const std::size_t total{headerSize + size};
+
+        // aligned_alloc wants the size to be a multiple of the alignment
+        void *block{alignment > alignof(std::max_align_t)
+                        ? std::aligned_alloc(alignment, (total + alignment - 1) / alignment * alignment)
+                        : std::malloc(total)};
+
+        if (!block)
+            throw std::bad_alloc{};
+
+        const std::uint32_t phase{AllocationTracker::getPhase()};
+
+        ::new (static_cast<char *>(block) + headerSize - sizeof(Header)) Header{size, phase};
+        AllocationTracker::recordAllocation(phase, size);
+
+        return static_cast<char *>(block) + headerSize;
+    }
+
+    void release(void *memory, std::size_t alignment) noexcept
+    {
+        if (!memory)
+            return;
+
+        const std::size_t headerSize{getHeaderSize(alignment)};
+        const Header *header{reinterpret_cast<const Header *>(static_cast<char *>(memory) - sizeof(Header))};
+
+        AllocationTracker::recordFree(header->phase, static_cast<std::size_t>(header->size));
+        std::free(static_cast<char *>(memory) - headerSize);
+    }
+
+    constexpr std::size_t defaultAlignment{alignof(std::max_align_t)};
+}
+
+void *operator new(std::size_t size) { return allocate(size, defaultAlignment); }
+void *operator new[](std::size_t size) { return allocate(size, defaultAlignment); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return allocate(size, static_cast<std::size_t>(alignment)); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return allocate(size, static_cast<std::size_t>(alignment)); }
+
+void operator delete(void *memory) noexcept { release(memory, defaultAlignment); }
+void operator delete[](void *memory) noexcept { release(memory, defaultAlignment); }
+void operator delete(void *memory, std::size_t) noexcept { release(memory, defaultAlignment); }
+void operator delete[](void *memory, std::size_t) noexcept { release(memory, defaultAlignment); }
+void operator delete(void *memory, std::align_val_t alignment) noexcept { release(memory, static_cast<std::size_t>(alignment)); }
+void operator delete[](void *memory, std::align_val_t alignment) noexcept { release(memory, static_cast<std::size_t>(alignment)); }
+void operator delete(void *memory, std::size_t, std::align_val_t alignment) noexcept { release(memory, static_cast<std::size_t>(alignment)); }
+void operator delete[](void *memory, std::size_t, std::align_val_t alignment) noexcept { release(memory, static_cast<std::size_t>(alignment)); }
+
+#endif
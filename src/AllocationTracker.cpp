@@ -0,0 +1,153 @@
+#include "AllocationTracker.h"
+#include <array>       // for std::array
+#include <atomic>      // for std::atomic
+#include <mutex>       // for std::mutex, std::scoped_lock
+#include <string_view> // for std::string_view
+
+namespace
+{
+    // more than there are phases in a tick and a frame
+    // scopes past it are counted as "other"
+    constexpr std::size_t maxPhases{64};
+
+    // phase 0, everything outside a scope
+    constexpr std::uint32_t otherPhase{0};
+
+    struct Counters
+    {
+        std::atomic<const char *> name{};
+
+        std::atomic<std::uint64_t> allocations{};
+        std::atomic<std::uint64_t> frees{};
+        std::atomic<std::uint64_t> bytes{};
+        std::atomic<std::uint64_t> liveBytes{};
+        std::atomic<std::uint64_t> peakBytes{};
+    };
+
+    std::array<Counters, maxPhases> g_phases{};
+
+    // phases are only ever added, under the mutex, and
+    // published by bumping the count
+    std::atomic<std::uint32_t> g_phaseCount{1};
+    std::mutex g_addPhase{};
+
+    std::atomic<std::uint64_t> g_allocations{};
+
+    // constinit so the hooks can use it before
+    // anything else of the process is set up
+    constinit thread_local std::uint32_t t_phase{otherPhase};
+
+    // phases are matched by pointer first, the same literal is
+    // usually at one address. by name if not, so the same name
+    // in two files is still one phase
+    std::uint32_t findPhase(const char *name, std::uint32_t count)
+    {
+        for (std::uint32_t phase{1}; phase < count; ++phase)
+        {
+            if (g_phases[phase].name.load(std::memory_order_relaxed) == name)
+                return phase;
+        }
+
+        for (std::uint32_t phase{1}; phase < count; ++phase)
+        {
+            if (std::string_view{g_phases[phase].name.load(std::memory_order_relaxed)} == name)
+                return phase;
+        }
+
+        return otherPhase;
+    }
+
+    std::uint32_t addPhase(const char *name)
+    {
+        const std::scoped_lock lock{g_addPhase};
+        const std::uint32_t count{g_phaseCount.load(std::memory_order_relaxed)};
+
+        // added by another thread in the meantime
+        if (const std::uint32_t phase{findPhase(name, count)}; phase != otherPhase)
+            return phase;
+
+        if (count == maxPhases)
+            return otherPhase;
+
+        g_phases[count].name.store(name, std::memory_order_relaxed);
+        g_phaseCount.store(count + 1, std::memory_order_release);
+
+        return count;
+    }
+}
+
+namespace AllocationTracker
+{
+    bool isEnabled()
+    {
+#if defined(MISSILE_COMMANDER_TRACK_ALLOCATIONS)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    std::uint32_t getPhase() { return t_phase; }
+
+    void recordAllocation(std::uint32_t phase, std::size_t bytes)
+    {
+        Counters &counters{g_phases[phase]};
+
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+        const std::uint64_t live{counters.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes};
+        std::uint64_t peak{counters.peakBytes.load(std::memory_order_relaxed)};
+
+        while (live > peak && !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void recordFree(std::uint32_t phase, std::size_t bytes)
+    {
+        Counters &counters{g_phases[phase]};
+
+        counters.frees.fetch_add(1, std::memory_order_relaxed);
+        counters.liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    std::uint64_t getAllocations() { return g_allocations.load(std::memory_order_relaxed); }
+
+    void collect(std::vector<PhaseStats> &stats)
+    {
+        stats.clear();
+
+        const std::uint32_t count{g_phaseCount.load(std::memory_order_acquire)};
+
+        for (std::uint32_t phase{0}; phase < count; ++phase)
+        {
+            const Counters &counters{g_phases[phase]};
+
+            stats.push_back(PhaseStats{
+                phase == otherPhase ? "other" : counters.name.load(std::memory_order_relaxed),
+                counters.allocations.load(std::memory_order_relaxed),
+                counters.frees.load(std::memory_order_relaxed),
+                counters.bytes.load(std::memory_order_relaxed),
+                counters.liveBytes.load(std::memory_order_relaxed),
+                counters.peakBytes.load(std::memory_order_relaxed),
+            });
+        }
+    }
+
+    std::uint32_t enter(const char *name)
+    {
+        const std::uint32_t previous{t_phase};
+        std::uint32_t phase{findPhase(name, g_phaseCount.load(std::memory_order_acquire))};
+
+        if (phase == otherPhase)
+            phase = addPhase(name);
+
+        t_phase = phase;
+
+        return previous;
+    }
+
+    void leave(std::uint32_t previous) { t_phase = previous; }
+}
@@ -0,0 +1,151 @@
+#include "ByteStream.h"
+#include <bit> // for std::bit_cast
+
+ByteWriter::ByteWriter(std::vector<std::uint8_t> &bytes)
+    : m_bytes{bytes}
+{
+}
+
+void ByteWriter::writeU8(std::uint8_t value)
+{
+    m_bytes.push_back(value);
+}
+
+void ByteWriter::writeU32(std::uint32_t value)
+{
+    for (int byte{0}; byte < 4; ++byte)
+        m_bytes.push_back(static_cast<std::uint8_t>(value >> (8 * byte)));
+}
+
+void ByteWriter::writeU64(std::uint64_t value)
+{
+    for (int byte{0}; byte < 8; ++byte)
+        m_bytes.push_back(static_cast<std::uint8_t>(value >> (8 * byte)));
+}
+
+void ByteWriter::writeFloat(float value)
+{
+    // the exact bits, so a float read back is
+    // the same float and not just a close one
+    writeU32(std::bit_cast<std::uint32_t>(value));
+}
+
+void ByteWriter::writeVarint(std::uint64_t value)
+{
+    // low 7 bits first, the top bit says more follow
+    while (value >= 0x80)
+    {
+        m_bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+
+    m_bytes.push_back(static_cast<std::uint8_t>(value));
+}
+
+void ByteWriter::writeZigzag(std::int64_t value)
+{
+    // 0, -1, 1, -2, 2, ... become 0, 1, 2, 3, 4, ...
+    const auto bits{static_cast<std::uint64_t>(value)};
+    writeVarint((bits << 1) ^ (value < 0 ? ~std::uint64_t{0} : 0));
+}
+
+void ByteWriter::writeBytes(std::span<const std::uint8_t> bytes)
+{
+    m_bytes.insert(m_bytes.end(), bytes.begin(), bytes.end());
+}
+
+void ByteWriter::writePadding(std::size_t alignment)
+{
+    while (m_bytes.size() % alignment != 0)
+        m_bytes.push_back(0);
+}
+
+ByteReader::ByteReader(std::span<const std::uint8_t> bytes)
+    : m_bytes{bytes}
+{
+}
+
+std::uint8_t ByteReader::readU8()
+{
+    if (m_position >= m_bytes.size())
+    {
+        m_failed = true;
+        return 0;
+    }
+
+    return m_bytes[m_position++];
+}
+
+std::uint32_t ByteReader::readU32()
+{
+    std::uint32_t value{0};
+
+    for (int byte{0}; byte < 4; ++byte)
+        value |= static_cast<std::uint32_t>(readU8()) << (8 * byte);
+
+    return value;
+}
+
+std::uint64_t ByteReader::readU64()
+{
+    std::uint64_t value{0};
+
+    for (int byte{0}; byte < 8; ++byte)
+        value |= static_cast<std::uint64_t>(readU8()) << (8 * byte);
+
+    return value;
+}
+
+float ByteReader::readFloat()
+{
+    return std::bit_cast<float>(readU32());
+}
+
+std::uint64_t ByteReader::readVarint()
+{
+    std::uint64_t value{0};
+
+    // 10 bytes hold any 64 bit value
+    for (int shift{0}; shift < 70; shift += 7)
+    {
+        const std::uint8_t byte{readU8()};
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+
+        if (!(byte & 0x80))
+            return value;
+    }
+
+    m_failed = true;
+    return 0;
+}
+
+std::int64_t ByteReader::readZigzag()
+{
+    const std::uint64_t bits{readVarint()};
+    return static_cast<std::int64_t>((bits >> 1) ^ (0 - (bits & 1)));
+}
+
+std::span<const std::uint8_t> ByteReader::readBytes(std::size_t count)
+{
+    if (count > getRemaining())
+    {
+        m_failed = true;
+        return {};
+    }
+
+    const std::span<const std::uint8_t> bytes{m_bytes.subspan(m_position, count)};
+    m_position += count;
+
+    return bytes;
+}
+
+void ByteReader::skipPadding(std::size_t alignment)
+{
+    readBytes((alignment - m_position % alignment) % alignment);
+}
+
+bool ByteReader::hasFailed() const { return m_failed; }
+bool ByteReader::isAtEnd() const { return m_position >= m_bytes.size(); }
+
+std::size_t ByteReader::getPosition() const { return m_position; }
+std::size_t ByteReader::getRemaining() const { return m_bytes.size() - m_position; }
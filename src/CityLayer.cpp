@@ -0,0 +1,211 @@
+#include "CityLayer.h"
+#include "RenderSnapshot.h"
+#include <raylib.h>
+#include <algorithm> // for std::sort, std::min, std::max, std::copy_n, std::transform
+#include <cmath>     // for std::lround
+#include <cstddef>   // for std::size_t
+#include <span>      // for std::span
+#include <tuple>     // for std::tie
+
+namespace
+{
+    using BuildingView = RenderSnapshot::BuildingView;
+
+    // any order will do as long as it's always the same
+    bool isBefore(const BuildingView &a, const BuildingView &b)
+    {
+        return std::tie(a.rectangle.x, a.rectangle.y, a.rectangle.width, a.rectangle.height, a.tint.r, a.tint.g, a.tint.b, a.tint.a) <
+               std::tie(b.rectangle.x, b.rectangle.y, b.rectangle.width, b.rectangle.height, b.tint.r, b.tint.g, b.tint.b, b.tint.a);
+    }
+
+    bool overlaps(const PixelRect &a, const PixelRect &b)
+    {
+        return a.x < b.x + b.width && b.x < a.x + a.width &&
+               a.y < b.y + b.height && b.y < a.y + a.height;
+    }
+
+    // src drawn over dst the way alpha blending on the GPU
+    // does it, src * a + dst * (1 - a), with the alpha of
+    // the result composited the same way so a translucent
+    // building over the (opaque) background stays opaque
+    Color blend(const Color &dst, const Color &src)
+    {
+        const int alpha{src.a};
+        const int inverse{255 - alpha};
+        const int dstAlpha{dst.a * inverse};
+        const int outAlpha{alpha * 255 + dstAlpha};
+
+        if (outAlpha == 0)
+            return Color{0, 0, 0, 0};
+
+        const auto channel{[&](int srcChannel, int dstChannel)
+                           { return static_cast<unsigned char>((srcChannel * alpha * 255 + dstChannel * dstAlpha + outAlpha / 2) / outAlpha); }};
+
+        return Color{channel(src.r, dst.r), channel(src.g, dst.g), channel(src.b, dst.b),
+                     static_cast<unsigned char>((outAlpha + 127) / 255)};
+    }
+
+    PixelRect intersect(const PixelRect &a, const PixelRect &b)
+    {
+        const int left{std::max(a.x, b.x)};
+        const int top{std::max(a.y, b.y)};
+        const int right{std::min(a.x + a.width, b.x + b.width)};
+        const int bottom{std::min(a.y + a.height, b.y + b.height)};
+
+        return PixelRect{left, top, right - left, bottom - top};
+    }
+}
+
+CityLayer::CityLayer(int width, int height, const Color &background)
+    : m_width{std::max(0, width)},
+      m_height{std::max(0, height)},
+      m_background{background},
+      m_pixels(static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height), background)
+{
+}
+
+bool CityLayer::update(std::span<const RenderSnapshot::BuildingView> buildings, std::uint64_t version)
+{
+    if (m_isBuilt && version == m_version)
+        return false;
+
+    m_incoming.assign(buildings.begin(), buildings.end());
+    std::sort(m_incoming.begin(), m_incoming.end(), isBefore);
+
+    const std::size_t firstDirty{m_dirty.size()};
+
+    if (!m_isBuilt)
+        m_dirty.push_back(PixelRect{0, 0, m_width, m_height});
+    else
+    {
+        // walk both sorted sets at once, a building in only
+        // one of them came or went and its pixels change
+        std::size_t old{0};
+        std::size_t incoming{0};
+
+        while (old < m_buildings.size() || incoming < m_incoming.size())
+        {
+            if (incoming == m_incoming.size() || (old < m_buildings.size() && isBefore(m_buildings[old], m_incoming[incoming])))
+                m_dirty.push_back(toPixels(m_buildings[old++].rectangle));
+            else if (old == m_buildings.size() || isBefore(m_incoming[incoming], m_buildings[old]))
+                m_dirty.push_back(toPixels(m_incoming[incoming++].rectangle));
+            else
+            {
+                ++old;
+                ++incoming;
+            }
+        }
+    }
+
+    m_buildings.swap(m_incoming);
+    m_drawOrder.assign(buildings.begin(), buildings.end());
+    m_version = version;
+    m_isBuilt = true;
+
+    for (std::size_t dirty{firstDirty}; dirty < m_dirty.size(); ++dirty)
+        redraw(m_dirty[dirty]);
+
+    return m_dirty.size() > firstDirty;
+}
+
+std::span<const PixelRect> CityLayer::getDirtyRects() const { return m_dirty; }
+void CityLayer::clearDirty() { m_dirty.clear(); }
+
+Image CityLayer::getImage()
+{
+    return Image{m_pixels.data(), m_width, m_height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+}
+
+void CityLayer::copyPixels(const PixelRect &region, std::vector<Color> &pixels) const
+{
+    const PixelRect clipped{intersect(region, PixelRect{0, 0, m_width, m_height})};
+
+    pixels.clear();
+
+    if (clipped.isEmpty())
+        return;
+
+    for (int y{clipped.y}; y < clipped.y + clipped.height; ++y)
+    {
+        const auto row{m_pixels.begin() + static_cast<std::ptrdiff_t>(y * m_width + clipped.x)};
+        pixels.insert(pixels.end(), row, row + clipped.width);
+    }
+}
+
+Color CityLayer::getPixel(int x, int y) const
+{
+    return m_pixels[static_cast<std::size_t>(y * m_width + x)];
+}
+
+int CityLayer::getWidth() const { return m_width; }
+int CityLayer::getHeight() const { return m_height; }
+
+std::uint64_t CityLayer::getRasterizedPixels() const { return m_rasterizedPixels; }
+
+PixelRect CityLayer::toPixels(const Rectangle &rectangle) const
+{
+    // a pixel is covered when its centre is,
+    // the same rule the GPU rasterizes with
+    const auto left{static_cast<int>(std::lround(rectangle.x))};
+    const auto top{static_cast<int>(std::lround(rectangle.y))};
+    const auto right{static_cast<int>(std::lround(rectangle.x + rectangle.width))};
+    const auto bottom{static_cast<int>(std::lround(rectangle.y + rectangle.height))};
+
+    return intersect(PixelRect{left, top, right - left, bottom - top}, PixelRect{0, 0, m_width, m_height});
+}
+
+void CityLayer::fill(const PixelRect &region, const Color &tint)
+{
+    if (region.isEmpty())
+        return;
+
+    for (int y{region.y}; y < region.y + region.height; ++y)
+    {
+        const auto row{m_pixels.begin() + static_cast<std::ptrdiff_t>(y * m_width + region.x)};
+        std::fill(row, row + region.width, tint);
+    }
+
+    m_rasterizedPixels += static_cast<std::uint64_t>(region.width) * static_cast<std::uint64_t>(region.height);
+}
+
+void CityLayer::paint(const PixelRect &region, const Color &tint)
+{
+    // an opaque tint just replaces the pixels
+    if (tint.a == 255)
+    {
+        fill(region, tint);
+        return;
+    }
+
+    if (region.isEmpty())
+        return;
+
+    for (int y{region.y}; y < region.y + region.height; ++y)
+    {
+        const auto row{m_pixels.begin() + static_cast<std::ptrdiff_t>(y * m_width + region.x)};
+
+        std::transform(row, row + region.width, row, [&tint](const Color &pixel)
+                       { return blend(pixel, tint); });
+    }
+
+    m_rasterizedPixels += static_cast<std::uint64_t>(region.width) * static_cast<std::uint64_t>(region.height);
+}
+
+void CityLayer::redraw(const PixelRect &region)
+{
+    if (region.isEmpty())
+        return;
+
+    fill(region, m_background);
+
+    // in snapshot order, the order DrawRectangleRec() drew
+    // them in, so overlapping buildings end up the same way
+    // round and translucent ones blend over the same pixels
+    for (const BuildingView &building : m_drawOrder)
+    {
+        const PixelRect pixels{toPixels(building.rectangle)};
+
+        if (overlaps(pixels, region))
+            paint(intersect(pixels, region), building.tint);
+    }
+}
@@ -0,0 +1,45 @@
+#include "CommandBuffer.h"
+#include "Missile.h"
+#include "Explosion.h"
+#include "SlotMap.h"
+
+CommandBuffer::CommandBuffer(std::size_t maxMissiles, std::size_t maxExplosions)
+{
+    for (std::vector<Handle> &kills : m_missileKills)
+        kills.reserve(maxMissiles * 2);
+
+    m_explosionKills.reserve(maxExplosions);
+    m_buildingKills.reserve(maxMissiles);
+    m_missileSpawns.reserve(maxMissiles * factionCount);
+    m_explosionSpawns.reserve(maxMissiles);
+}
+
+void CommandBuffer::killMissile(Faction faction, const Handle &missile) { m_missileKills[static_cast<std::size_t>(faction)].push_back(missile); }
+void CommandBuffer::killExplosion(const Handle &explosion) { m_explosionKills.push_back(explosion); }
+void CommandBuffer::killBuilding(const Handle &building) { m_buildingKills.push_back(building); }
+
+void CommandBuffer::spawnMissile(const Missile &missile) { m_missileSpawns.push_back(missile); }
+void CommandBuffer::spawnExplosion(const Explosion &explosion) { m_explosionSpawns.push_back(explosion); }
+
+void CommandBuffer::reserveMissileSpawns(std::size_t count)
+{
+    m_missileSpawns.reserve(m_missileSpawns.size() + count);
+}
+
+std::span<const Handle> CommandBuffer::getMissileKills(Faction faction) const { return m_missileKills[static_cast<std::size_t>(faction)]; }
+std::span<const Handle> CommandBuffer::getExplosionKills() const { return m_explosionKills; }
+std::span<const Handle> CommandBuffer::getBuildingKills() const { return m_buildingKills; }
+
+std::span<const Missile> CommandBuffer::getMissileSpawns() const { return m_missileSpawns; }
+std::span<const Explosion> CommandBuffer::getExplosionSpawns() const { return m_explosionSpawns; }
+
+void CommandBuffer::clear()
+{
+    for (std::vector<Handle> &kills : m_missileKills)
+        kills.clear();
+
+    m_explosionKills.clear();
+    m_buildingKills.clear();
+    m_missileSpawns.clear();
+    m_explosionSpawns.clear();
+}
@@ -0,0 +1,174 @@
+#include "CoverageMap.h"
+#include <raylib.h>
+#include <algorithm> // for std::fill, std::max, std::min
+#include <cmath>     // for std::ceil, std::sqrt, std::fabs
+#include <bit>       // for std::popcount
+#include <cassert>   // for assert
+#include <cstdint>   // for std::int32_t
+
+namespace
+{
+    constexpr std::size_t bitsPerWord{64};
+
+    // every bit from bit on (inclusive) to the top of a word
+    constexpr std::uint64_t bitsFrom(std::size_t bit)
+    {
+        return ~std::uint64_t{0} << bit;
+    }
+
+    // every bit from the bottom of a word up to bit (inclusive)
+    constexpr std::uint64_t bitsUpTo(std::size_t bit)
+    {
+        return ~std::uint64_t{0} >> (bitsPerWord - 1 - bit);
+    }
+
+    // the first cell starting at or after cell coordinate
+    // x and the first one starting after it, for any x in
+    // [0, 2^24]. std::ceil and std::floor are calls into
+    // libm on plain x86-64, and so is anything converting
+    // between floats and 64 bit unsigned integers, these
+    // stay on 32 bit ints and are a couple of instructions
+    std::int32_t ceilCell(float x)
+    {
+        const auto cell{static_cast<std::int32_t>(x)};
+        return cell + (static_cast<float>(cell) < x);
+    }
+
+    std::int32_t floorCell(float x)
+    {
+        return static_cast<std::int32_t>(x);
+    }
+}
+
+CoverageMap::CoverageMap(float width, float height, float cellSize)
+    : m_cellSize{cellSize},
+      m_cellsPerUnit{1.0f / cellSize}
+{
+    assert(cellSize > 0.0f && "cell size must be positive");
+
+    // always keep at least one cell
+    m_columns = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(width / m_cellSize)));
+    m_rows = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(height / m_cellSize)));
+    m_wordsPerRow = (m_columns + bitsPerWord - 1) / bitsPerWord;
+
+    m_words.assign(m_rows * m_wordsPerRow, 0);
+
+    // nothing is dirty yet
+    m_firstDirtyRow = m_rows;
+    m_lastDirtyRow = 0;
+}
+
+void CoverageMap::clear()
+{
+    if (m_firstDirtyRow <= m_lastDirtyRow)
+    {
+        std::fill(m_words.begin() + static_cast<std::ptrdiff_t>(m_firstDirtyRow * m_wordsPerRow),
+                  m_words.begin() + static_cast<std::ptrdiff_t>((m_lastDirtyRow + 1) * m_wordsPerRow),
+                  std::uint64_t{0});
+    }
+
+    m_firstDirtyRow = m_rows;
+    m_lastDirtyRow = 0;
+}
+
+void CoverageMap::fillCircle(const Vector2 &center, float radius)
+{
+    if (radius <= 0.0f)
+        return;
+
+    // in cells from here on, the map spans [0, columns) x [0, rows)
+    const float x{center.x * m_cellsPerUnit};
+    const float y{center.y * m_cellsPerUnit};
+    const float r{radius * m_cellsPerUnit};
+
+    const auto columns{static_cast<float>(m_columns)};
+    const auto rows{static_cast<float>(m_rows)};
+
+    // only the rows whose whole height is within the circle
+    // can have a cell inside it, row r spans [r, r + 1)
+    // (checked in floats first, anything can be off the map)
+    if (y + r < 1.0f || y - r > rows)
+        return;
+
+    const std::int32_t firstRow{ceilCell(std::max(0.0f, y - r))};
+    const std::int32_t endRow{floorCell(std::min(rows, y + r))};
+
+    for (std::int32_t row{firstRow}; row < endRow; ++row)
+    {
+        // the half width of the circle at the edge of the
+        // row farther from the center is as wide as it gets
+        // for the whole row
+        const auto top{static_cast<float>(row)};
+        const float dy{std::max(std::fabs(top - y), std::fabs(top + 1.0f - y))};
+
+        if (dy >= r)
+            continue;
+
+        const float halfWidth{std::sqrt(r * r - dy * dy)};
+
+        if (x + halfWidth < 1.0f || x - halfWidth > columns)
+            continue;
+
+        const std::int32_t firstColumn{ceilCell(std::max(0.0f, x - halfWidth))};
+        const std::int32_t endColumn{floorCell(std::min(columns, x + halfWidth))};
+
+        if (firstColumn < endColumn)
+            fillSpan(static_cast<std::size_t>(row), static_cast<std::size_t>(firstColumn), static_cast<std::size_t>(endColumn - 1));
+    }
+}
+
+bool CoverageMap::isCovered(const Vector2 &point) const
+{
+    const float column{point.x * m_cellsPerUnit};
+    const float row{point.y * m_cellsPerUnit};
+
+    // written so NaN ends up outside too
+    if (!(column >= 0.0f && column < static_cast<float>(m_columns) && row >= 0.0f && row < static_cast<float>(m_rows)))
+        return false;
+
+    const auto x{static_cast<std::size_t>(floorCell(column))};
+    const auto y{static_cast<std::size_t>(floorCell(row))};
+
+    return (m_words[y * m_wordsPerRow + x / bitsPerWord] >> (x % bitsPerWord)) & 1;
+}
+
+float CoverageMap::getCellSize() const { return m_cellSize; }
+
+std::size_t CoverageMap::getColumnCount() const { return m_columns; }
+std::size_t CoverageMap::getRowCount() const { return m_rows; }
+
+std::size_t CoverageMap::getCoveredCells() const
+{
+    std::size_t cells{0};
+
+    for (std::uint64_t word : m_words)
+        cells += static_cast<std::size_t>(std::popcount(word));
+
+    return cells;
+}
+
+void CoverageMap::fillSpan(std::size_t row, std::size_t first, std::size_t last)
+{
+    m_firstDirtyRow = std::min(m_firstDirtyRow, row);
+    m_lastDirtyRow = std::max(m_lastDirtyRow, row);
+
+    std::uint64_t *words{m_words.data() + row * m_wordsPerRow};
+    const std::size_t firstWord{first / bitsPerWord};
+    const std::size_t lastWord{last / bitsPerWord};
+
+    // a span within one word is a single or
+    if (firstWord == lastWord)
+    {
+        words[firstWord] |= bitsFrom(first % bitsPerWord) & bitsUpTo(last % bitsPerWord);
+        return;
+    }
+
+    // otherwise the two partial words at the ends
+    // and whole words of 64 cells in between
+    words[firstWord] |= bitsFrom(first % bitsPerWord);
+
+    for (std::size_t word{firstWord + 1}; word < lastWord; ++word)
+        words[word] = ~std::uint64_t{0};
+
+    words[lastWord] |= bitsUpTo(last % bitsPerWord);
+}
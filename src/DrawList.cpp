@@ -0,0 +1,167 @@
+#include "DrawList.h"
+#include "RenderSnapshot.h"
+#include "Missile.h"
+#include <raylib.h>
+#include <raymath.h>
+#include <algorithm> // for std::sort
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint32_t, std::uint64_t
+#include <span>      // for std::span
+
+namespace
+{
+    // the layers of the game, drawn in this order
+    enum Layer : std::uint8_t
+    {
+        missileLayer,
+        buildingLayer,
+        explosionLayer,
+    };
+
+    // radius of the dot on the head of every missile
+    constexpr float missileHeadRadius{5.0f};
+
+    // the trail colour of every faction's missiles
+    Color getFactionTint(Faction faction)
+    {
+        return faction == Faction::player ? GREEN : RED;
+    }
+}
+
+void NullDrawBackend::drawBatch(const DrawBatch &batch, std::span<const DrawCommand> commands)
+{
+    ++m_batches;
+    m_commands[static_cast<std::size_t>(batch.primitive)] += commands.size();
+}
+
+std::uint64_t NullDrawBackend::getBatches() const { return m_batches; }
+
+std::uint64_t NullDrawBackend::getCommands() const
+{
+    return m_commands[0] + m_commands[1] + m_commands[2];
+}
+
+std::uint64_t NullDrawBackend::getCommands(DrawPrimitive primitive) const
+{
+    return m_commands[static_cast<std::size_t>(primitive)];
+}
+
+void NullDrawBackend::reset()
+{
+    m_batches = 0;
+    m_commands = {};
+}
+
+void DrawList::clear()
+{
+    m_layer = 0;
+    m_commands.clear();
+    m_sorted.clear();
+    m_batches.clear();
+}
+
+void DrawList::setLayer(std::uint8_t layer) { m_layer = layer; }
+
+void DrawList::addLine(const Vector2 &from, const Vector2 &to, const Color &tint)
+{
+    m_commands.push_back(DrawCommand{from, to, tint, DrawPrimitive::line, m_layer});
+}
+
+void DrawList::addCircle(const Vector2 &center, float radius, const Color &tint)
+{
+    m_commands.push_back(DrawCommand{center, Vector2{radius, 0.0f}, tint, DrawPrimitive::circle, m_layer});
+}
+
+void DrawList::addRectangle(const Rectangle &rectangle, const Color &tint)
+{
+    m_commands.push_back(DrawCommand{Vector2{rectangle.x, rectangle.y}, Vector2{rectangle.width, rectangle.height},
+                                     tint, DrawPrimitive::rectangle, m_layer});
+}
+
+void DrawList::addSnapshot(const RenderSnapshot &snapshot, float alpha)
+{
+    // a line and a head for every missile, a circle for every explosion
+    // the snapshot has room for all the world can hold, so this only
+    // allocates for the first one
+    m_commands.reserve(m_commands.size() + snapshot.missiles.capacity() * 2 + snapshot.explosions.capacity());
+
+    setLayer(missileLayer);
+
+    for (const RenderSnapshot::MissileView &missile : snapshot.missiles)
+    {
+        const Vector2 endPos{Vector2Lerp(missile.previousEndPos, missile.endPos, alpha)};
+
+        addLine(missile.startPos, endPos, getFactionTint(missile.faction));
+        addCircle(endPos, missileHeadRadius, RED);
+    }
+
+    setLayer(explosionLayer);
+
+    for (const RenderSnapshot::ExplosionView &explosion : snapshot.explosions)
+        addCircle(explosion.position, Lerp(explosion.previousRadius, explosion.radius, alpha), explosion.tint);
+}
+
+void DrawList::addBuildings(const RenderSnapshot &snapshot)
+{
+    setLayer(buildingLayer);
+
+    m_commands.reserve(m_commands.size() + snapshot.buildings.capacity());
+
+    for (const RenderSnapshot::BuildingView &building : snapshot.buildings)
+        addRectangle(building.rectangle, building.tint);
+}
+
+void DrawList::sort()
+{
+    // layer, then primitive, then colour
+    // the index breaks ties, so the order never
+    // depends on how std::sort shuffles equal keys
+    m_keys.clear();
+    m_keys.reserve(m_commands.capacity());
+
+    for (std::size_t command{0}; command < m_commands.size(); ++command)
+    {
+        const DrawCommand &draw{m_commands[command]};
+        const std::uint64_t colour{(static_cast<std::uint64_t>(draw.tint.r) << 24) |
+                                   (static_cast<std::uint64_t>(draw.tint.g) << 16) |
+                                   (static_cast<std::uint64_t>(draw.tint.b) << 8) |
+                                   draw.tint.a};
+
+        m_keys.push_back(SortKey{(static_cast<std::uint64_t>(draw.layer) << 40) |
+                                     (static_cast<std::uint64_t>(draw.primitive) << 32) | colour,
+                                 static_cast<std::uint32_t>(command)});
+    }
+
+    std::sort(m_keys.begin(), m_keys.end(), [](const SortKey &a, const SortKey &b)
+              { return a.key < b.key || (a.key == b.key && a.index < b.index); });
+
+    // the commands in draw order, cut into batches
+    // wherever the layer or the primitive changes
+    m_sorted.clear();
+    m_sorted.reserve(m_commands.capacity());
+    m_batches.clear();
+
+    for (const SortKey &key : m_keys)
+    {
+        const DrawCommand &draw{m_commands[key.index]};
+
+        if (m_batches.empty() || m_batches.back().layer != draw.layer || m_batches.back().primitive != draw.primitive)
+            m_batches.push_back(DrawBatch{draw.layer, draw.primitive, static_cast<std::uint32_t>(m_sorted.size()), 0});
+
+        m_sorted.push_back(draw);
+        ++m_batches.back().count;
+    }
+}
+
+void DrawList::submit(DrawBackend &backend)
+{
+    sort();
+
+    for (const DrawBatch &batch : m_batches)
+        backend.drawBatch(batch, std::span<const DrawCommand>{m_sorted}.subspan(batch.first, batch.count));
+}
+
+std::size_t DrawList::size() const { return m_commands.size(); }
+
+std::span<const DrawCommand> DrawList::getCommands() const { return m_sorted; }
+std::span<const DrawBatch> DrawList::getBatches() const { return m_batches; }
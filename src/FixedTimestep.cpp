@@ -0,0 +1,43 @@
+#include "FixedTimestep.h"
+#include <cassert> // for assert
+
+FixedTimestep::FixedTimestep(double tickRate, int maxStepsPerFrame)
+    : m_tickSeconds{1.0 / tickRate},
+      m_maxStepsPerFrame{maxStepsPerFrame}
+{
+    assert(tickRate > 0.0 && "tick rate must be positive");
+    assert(maxStepsPerFrame > 0 && "at least one step per frame is needed");
+}
+
+int FixedTimestep::advance(double frameSeconds)
+{
+    m_accumulator += frameSeconds;
+
+    int steps{0};
+
+    while (m_accumulator >= m_tickSeconds && steps < m_maxStepsPerFrame)
+    {
+        m_accumulator -= m_tickSeconds;
+        ++steps;
+    }
+
+    // the machine can't keep up, so drop the backlog
+    // and let the game slow down instead of freezing
+    while (m_accumulator >= m_tickSeconds)
+    {
+        m_accumulator -= m_tickSeconds;
+        ++m_droppedTicks;
+    }
+
+    return steps;
+}
+
+float FixedTimestep::getAlpha() const
+{
+    return static_cast<float>(m_accumulator / m_tickSeconds);
+}
+
+double FixedTimestep::getTickRate() const { return 1.0 / m_tickSeconds; }
+double FixedTimestep::getTickSeconds() const { return m_tickSeconds; }
+
+long long FixedTimestep::getDroppedTicks() const { return m_droppedTicks; }
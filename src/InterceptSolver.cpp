@@ -0,0 +1,270 @@
+#include "InterceptSolver.h"
+#include "MissileStore.h"
+#include <raylib.h>
+#include <cmath>   // for std::sqrt
+#include <cstddef> // for std::size_t
+#include <cstdint> // for std::int64_t
+#include <span>    // for std::span
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h> // for SSE/AVX intrinsics
+#endif
+
+/*
+    the SIMD and scalar paths must stay bit-identical,
+    for the same reasons as in MissileStore.cpp:
+    every operation in the same order, min and max written
+    the way minps and maxps pick, sqrt is exact everywhere
+    and -ffp-contract=off keeps the compiler from fusing into FMAs
+*/
+
+InterceptSolver::InterceptSolver(std::size_t capacity)
+{
+    m_startX.reserve(capacity);
+    m_startY.reserve(capacity);
+    m_dirX.reserve(capacity);
+    m_dirY.reserve(capacity);
+    m_length.reserve(capacity);
+    m_speed.reserve(capacity);
+    m_rampTicks.reserve(capacity);
+    m_age.reserve(capacity);
+    m_maxAhead.reserve(capacity);
+}
+
+void InterceptSolver::gather(const MissileStore &missiles, std::span<const std::uint32_t> indices, std::uint64_t tick)
+{
+    m_startX.clear();
+    m_startY.clear();
+    m_dirX.clear();
+    m_dirY.clear();
+    m_length.clear();
+    m_speed.clear();
+    m_rampTicks.clear();
+    m_age.clear();
+    m_maxAhead.clear();
+
+    m_topSpeed = missiles.getTopSpeed();
+
+    for (std::uint32_t index : indices)
+    {
+        const Vector2 start{missiles.getStartPos(index)};
+        const Vector2 direction{missiles.getDirection(index)};
+
+        m_startX.push_back(start.x);
+        m_startY.push_back(start.y);
+        m_dirX.push_back(direction.x);
+        m_dirY.push_back(direction.y);
+        m_length.push_back(missiles.getLength(index));
+        m_speed.push_back(missiles.getMissileSpeed(index));
+        m_rampTicks.push_back(missiles.getRampTicks(index));
+        m_age.push_back(missiles.getAge(index, static_cast<double>(tick + 1)));
+
+        // an explosion has to be there the tick
+        // before the threat lands, not on it
+        const std::uint64_t arrival{missiles.getArrivalTick(index)};
+        const std::int64_t maxAhead{arrival > tick + 2 ? static_cast<std::int64_t>(arrival - tick - 2) : -1};
+
+        m_maxAhead.push_back(static_cast<float>(maxAhead));
+    }
+}
+
+std::size_t InterceptSolver::size() const { return m_age.size(); }
+
+namespace
+{
+#if defined(__AVX2__)
+    // MissileStore::getTravelled() for 8 missiles
+    __m256 getTravelled8(__m256 age, __m256 speed, __m256 rampTicks, __m256 topSpeed)
+    {
+        const __m256 one{_mm256_set1_ps(1.0f)};
+        age = _mm256_max_ps(one, age);
+        const __m256 ramp{_mm256_min_ps(rampTicks, age)};
+
+        return _mm256_add_ps(
+            _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(speed, ramp), _mm256_sub_ps(ramp, one)), _mm256_set1_ps(0.5f)),
+            _mm256_mul_ps(topSpeed, _mm256_sub_ps(age, ramp)));
+    }
+#endif
+
+#if defined(__SSE2__)
+    // MissileStore::getTravelled() for 4 missiles
+    __m128 getTravelled4(__m128 age, __m128 speed, __m128 rampTicks, __m128 topSpeed)
+    {
+        const __m128 one{_mm_set1_ps(1.0f)};
+        age = _mm_max_ps(one, age);
+        const __m128 ramp{_mm_min_ps(rampTicks, age)};
+
+        return _mm_add_ps(
+            _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(speed, ramp), _mm_sub_ps(ramp, one)), _mm_set1_ps(0.5f)),
+            _mm_mul_ps(topSpeed, _mm_sub_ps(age, ramp)));
+    }
+#endif
+}
+
+void InterceptSolver::solve(Vector2 launcher, float speed, float topSpeed, std::span<float> ahead) const
+{
+    const Launcher from{launcher.x, launcher.y, speed, MissileStore::getRampTicks(speed, topSpeed), topSpeed};
+
+    const std::size_t count{size()};
+    std::size_t i{0};
+
+#if defined(__AVX2__)
+    const __m256 launcherX8{_mm256_set1_ps(from.x)};
+    const __m256 launcherY8{_mm256_set1_ps(from.y)};
+    const __m256 launcherSpeed8{_mm256_set1_ps(from.speed)};
+    const __m256 launcherRamp8{_mm256_set1_ps(from.rampTicks)};
+    const __m256 launcherTop8{_mm256_set1_ps(from.topSpeed)};
+    const __m256 threatTop8{_mm256_set1_ps(m_topSpeed)};
+    const __m256 half8{_mm256_set1_ps(0.5f)};
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 startX{_mm256_loadu_ps(m_startX.data() + i)};
+        const __m256 startY{_mm256_loadu_ps(m_startY.data() + i)};
+        const __m256 dirX{_mm256_loadu_ps(m_dirX.data() + i)};
+        const __m256 dirY{_mm256_loadu_ps(m_dirY.data() + i)};
+        const __m256 length{_mm256_loadu_ps(m_length.data() + i)};
+        const __m256 threatSpeed{_mm256_loadu_ps(m_speed.data() + i)};
+        const __m256 threatRamp{_mm256_loadu_ps(m_rampTicks.data() + i)};
+        const __m256 age{_mm256_loadu_ps(m_age.data() + i)};
+        const __m256 maxAhead{_mm256_loadu_ps(m_maxAhead.data() + i)};
+
+        // interceptor distance - distance to the threat
+        const auto getGap{[&](__m256 ticksAhead)
+                          {
+                              const __m256 travelled{getTravelled8(_mm256_add_ps(age, ticksAhead), threatSpeed, threatRamp, threatTop8)};
+                              const __m256 along{_mm256_min_ps(length, travelled)};
+                              const __m256 dx{_mm256_sub_ps(_mm256_add_ps(startX, _mm256_mul_ps(dirX, along)), launcherX8)};
+                              const __m256 dy{_mm256_sub_ps(_mm256_add_ps(startY, _mm256_mul_ps(dirY, along)), launcherY8)};
+                              const __m256 distance{_mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)))};
+
+                              return _mm256_sub_ps(getTravelled8(ticksAhead, launcherSpeed8, launcherRamp8, launcherTop8), distance);
+                          }};
+
+        const __m256 reachable{_mm256_and_ps(_mm256_cmp_ps(maxAhead, _mm256_set1_ps(1.0f), _CMP_GE_OQ),
+                                             _mm256_cmp_ps(getGap(maxAhead), _mm256_setzero_ps(), _CMP_GE_OQ))};
+
+        __m256 low{_mm256_setzero_ps()};
+        __m256 high{maxAhead};
+
+        for (int step{0}; step < steps; ++step)
+        {
+            const __m256 middle{_mm256_mul_ps(_mm256_add_ps(low, high), half8)};
+            const __m256 caught{_mm256_cmp_ps(getGap(middle), _mm256_setzero_ps(), _CMP_GE_OQ)};
+
+            high = _mm256_blendv_ps(high, middle, caught);
+            low = _mm256_blendv_ps(middle, low, caught);
+        }
+
+        _mm256_storeu_ps(ahead.data() + i, _mm256_blendv_ps(_mm256_set1_ps(-1.0f), high, reachable));
+    }
+#endif
+
+#if defined(__SSE2__)
+    const __m128 launcherX4{_mm_set1_ps(from.x)};
+    const __m128 launcherY4{_mm_set1_ps(from.y)};
+    const __m128 launcherSpeed4{_mm_set1_ps(from.speed)};
+    const __m128 launcherRamp4{_mm_set1_ps(from.rampTicks)};
+    const __m128 launcherTop4{_mm_set1_ps(from.topSpeed)};
+    const __m128 threatTop4{_mm_set1_ps(m_topSpeed)};
+    const __m128 half4{_mm_set1_ps(0.5f)};
+
+    // SSE2 has no blend, so select with and/andnot/or
+    const auto select{[](__m128 mask, __m128 ifSet, __m128 ifClear)
+                      { return _mm_or_ps(_mm_and_ps(mask, ifSet), _mm_andnot_ps(mask, ifClear)); }};
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 startX{_mm_loadu_ps(m_startX.data() + i)};
+        const __m128 startY{_mm_loadu_ps(m_startY.data() + i)};
+        const __m128 dirX{_mm_loadu_ps(m_dirX.data() + i)};
+        const __m128 dirY{_mm_loadu_ps(m_dirY.data() + i)};
+        const __m128 length{_mm_loadu_ps(m_length.data() + i)};
+        const __m128 threatSpeed{_mm_loadu_ps(m_speed.data() + i)};
+        const __m128 threatRamp{_mm_loadu_ps(m_rampTicks.data() + i)};
+        const __m128 age{_mm_loadu_ps(m_age.data() + i)};
+        const __m128 maxAhead{_mm_loadu_ps(m_maxAhead.data() + i)};
+
+        // interceptor distance - distance to the threat
+        const auto getGap{[&](__m128 ticksAhead)
+                          {
+                              const __m128 travelled{getTravelled4(_mm_add_ps(age, ticksAhead), threatSpeed, threatRamp, threatTop4)};
+                              const __m128 along{_mm_min_ps(length, travelled)};
+                              const __m128 dx{_mm_sub_ps(_mm_add_ps(startX, _mm_mul_ps(dirX, along)), launcherX4)};
+                              const __m128 dy{_mm_sub_ps(_mm_add_ps(startY, _mm_mul_ps(dirY, along)), launcherY4)};
+                              const __m128 distance{_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)))};
+
+                              return _mm_sub_ps(getTravelled4(ticksAhead, launcherSpeed4, launcherRamp4, launcherTop4), distance);
+                          }};
+
+        const __m128 reachable{_mm_and_ps(_mm_cmpge_ps(maxAhead, _mm_set1_ps(1.0f)),
+                                          _mm_cmpge_ps(getGap(maxAhead), _mm_setzero_ps()))};
+
+        __m128 low{_mm_setzero_ps()};
+        __m128 high{maxAhead};
+
+        for (int step{0}; step < steps; ++step)
+        {
+            const __m128 middle{_mm_mul_ps(_mm_add_ps(low, high), half4)};
+            const __m128 caught{_mm_cmpge_ps(getGap(middle), _mm_setzero_ps())};
+
+            high = select(caught, middle, high);
+            low = select(caught, low, middle);
+        }
+
+        _mm_storeu_ps(ahead.data() + i, select(reachable, high, _mm_set1_ps(-1.0f)));
+    }
+#endif
+
+    // whatever doesn't fill a whole register
+    solveScalar(from, i, ahead);
+}
+
+void InterceptSolver::solveScalar(Vector2 launcher, float speed, float topSpeed, std::span<float> ahead) const
+{
+    const Launcher from{launcher.x, launcher.y, speed, MissileStore::getRampTicks(speed, topSpeed), topSpeed};
+
+    solveScalar(from, 0, ahead);
+}
+
+void InterceptSolver::solveScalar(const Launcher &launcher, std::size_t first, std::span<float> ahead) const
+{
+    for (std::size_t i{first}; i < size(); ++i)
+    {
+        // interceptor distance - distance to the threat
+        const auto getGap{[&](float ticksAhead)
+                          {
+                              const float travelled{MissileStore::getTravelled(m_age[i] + ticksAhead, m_speed[i], m_rampTicks[i], m_topSpeed)};
+                              const float along{(m_length[i] < travelled) ? m_length[i] : travelled};
+                              const float dx{m_startX[i] + m_dirX[i] * along - launcher.x};
+                              const float dy{m_startY[i] + m_dirY[i] * along - launcher.y};
+                              const float distance{std::sqrt(dx * dx + dy * dy)};
+
+                              return MissileStore::getTravelled(ticksAhead, launcher.speed, launcher.rampTicks, launcher.topSpeed) - distance;
+                          }};
+
+        const float maxAhead{m_maxAhead[i]};
+
+        // can't be caught even on the last tick before it lands
+        if (!(maxAhead >= 1.0f) || !(getGap(maxAhead) >= 0.0f))
+        {
+            ahead[i] = -1.0f;
+            continue;
+        }
+
+        float low{0.0f};
+        float high{maxAhead};
+
+        for (int step{0}; step < steps; ++step)
+        {
+            const float middle{(low + high) * 0.5f};
+
+            if (getGap(middle) >= 0.0f)
+                high = middle;
+            else
+                low = middle;
+        }
+
+        ahead[i] = high;
+    }
+}
@@ -0,0 +1,191 @@
+#include "JobSystem.h"
+
+namespace
+{
+    // ranges per thread, enough for stealing to even
+    // out uneven chunks without drowning in tiny jobs
+    constexpr std::size_t chunksPerThread{4};
+
+    // never hand out less than this many cache lines
+    // of work in one go, a job costs a lock or two
+    constexpr std::size_t minCacheLinesPerChunk{16};
+}
+
+JobSystem::JobSystem(unsigned workerCount)
+    : m_queues(workerCount > 0 ? workerCount : std::max(1u, std::thread::hardware_concurrency()) - 1)
+{
+    m_workers.reserve(m_queues.size());
+
+    for (std::size_t worker{0}; worker < m_queues.size(); ++worker)
+        m_workers.emplace_back([this, worker]
+                               { workerLoop(worker); });
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        const std::lock_guard lock{m_sleepMutex};
+        m_stopping = true;
+    }
+
+    m_wake.notify_all();
+
+    // jthread joins when destroyed
+    m_workers.clear();
+}
+
+unsigned JobSystem::getThreadCount() const
+{
+    return static_cast<unsigned>(m_workers.size()) + 1;
+}
+
+std::size_t JobSystem::getChunkSize(std::size_t count, std::size_t granularity) const
+{
+    granularity = std::max<std::size_t>(1, granularity);
+
+    // with no workers everything runs on the caller anyway
+    if (m_workers.empty())
+        return count;
+
+    const std::size_t chunkSize{std::max(getStealChunkSize(count), granularity * minCacheLinesPerChunk)};
+
+    // round up to whole cache lines
+    return (chunkSize + granularity - 1) / granularity * granularity;
+}
+
+std::size_t JobSystem::getStealChunkSize(std::size_t count) const
+{
+    if (m_workers.empty())
+        return count;
+
+    const std::size_t chunks{getThreadCount() * chunksPerThread};
+    return std::max<std::size_t>(1, (count + chunks - 1) / chunks);
+}
+
+void JobSystem::run(std::size_t count, std::size_t chunkSize, Invoke call, void *context)
+{
+    const std::size_t chunks{(count + chunkSize - 1) / chunkSize};
+    std::atomic<std::size_t> remaining{chunks};
+
+    // the first range is kept for the calling thread,
+    // the rest are dealt out round-robin
+    for (std::size_t chunk{1}; chunk < chunks; ++chunk)
+    {
+        const Job job{call, context, chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize), &remaining};
+
+        // a full queue just means we run the range ourselves
+        if (!push(chunk % m_queues.size(), job))
+            execute(job);
+    }
+
+    {
+        // taking the lock makes sure a worker about to sleep
+        // either sees the new jobs or gets the notification
+        const std::lock_guard lock{m_sleepMutex};
+    }
+
+    m_wake.notify_all();
+
+    execute(Job{call, context, 0, std::min(count, chunkSize), &remaining});
+
+    // help out until every range is done
+    while (remaining.load(std::memory_order_acquire) > 0)
+    {
+        Job job{};
+
+        if (findJob(0, job))
+            execute(job);
+        else
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::workerLoop(std::size_t self)
+{
+    while (true)
+    {
+        Job job{};
+
+        if (findJob(self, job))
+        {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock lock{m_sleepMutex};
+
+        m_wake.wait(lock, [this]
+                    { return m_stopping || m_queued.load(std::memory_order_acquire) > 0; });
+
+        if (m_stopping)
+            return;
+    }
+}
+
+bool JobSystem::push(std::size_t queue, const Job &job)
+{
+    WorkQueue &work{m_queues[queue]};
+    const std::lock_guard lock{work.mutex};
+
+    if (work.tail - work.head == WorkQueue::capacity)
+        return false;
+
+    work.jobs[work.tail % WorkQueue::capacity] = job;
+    ++work.tail;
+
+    m_queued.fetch_add(1, std::memory_order_release);
+
+    return true;
+}
+
+bool JobSystem::popBack(std::size_t queue, Job &job)
+{
+    WorkQueue &work{m_queues[queue]};
+    const std::lock_guard lock{work.mutex};
+
+    if (work.head == work.tail)
+        return false;
+
+    --work.tail;
+    job = work.jobs[work.tail % WorkQueue::capacity];
+
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+bool JobSystem::stealFront(std::size_t queue, Job &job)
+{
+    WorkQueue &work{m_queues[queue]};
+    const std::lock_guard lock{work.mutex};
+
+    if (work.head == work.tail)
+        return false;
+
+    job = work.jobs[work.head % WorkQueue::capacity];
+    ++work.head;
+
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+bool JobSystem::findJob(std::size_t self, Job &job)
+{
+    if (popBack(self, job))
+        return true;
+
+    for (std::size_t offset{1}; offset < m_queues.size(); ++offset)
+    {
+        if (stealFront((self + offset) % m_queues.size(), job))
+            return true;
+    }
+
+    return false;
+}
+
+void JobSystem::execute(const Job &job)
+{
+    job.invoke(job.context, job.first, job.last);
+    job.remaining->fetch_sub(1, std::memory_order_acq_rel);
+}
@@ -0,0 +1,75 @@
+#include "MappedFile.h"
+#include <fstream>  // for std::ifstream
+#include <iterator> // for std::istreambuf_iterator
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_FILE_MMAP
+#endif
+
+MappedFile::MappedFile(const std::string &path)
+{
+#if defined(MAPPED_FILE_MMAP)
+    const int fd{open(path.c_str(), O_RDONLY)};
+
+    if (fd < 0)
+        return;
+
+    struct stat status{};
+
+    if (fstat(fd, &status) == 0)
+    {
+        m_size = static_cast<std::size_t>(status.st_size);
+
+        // an empty file can't be mapped, but it opened fine
+        if (m_size == 0)
+            m_isOpen = true;
+        else
+        {
+            void *mapping{mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0)};
+
+            if (mapping != MAP_FAILED)
+            {
+                // we read front to back, let the kernel read ahead
+                madvise(mapping, m_size, MADV_SEQUENTIAL);
+
+                m_data = static_cast<const std::uint8_t *>(mapping);
+                m_isOpen = true;
+            }
+        }
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+#else
+    std::ifstream file{path, std::ios::binary};
+
+    if (!file)
+        return;
+
+    m_fallback.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+    m_data = m_fallback.data();
+    m_size = m_fallback.size();
+    m_isOpen = true;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(MAPPED_FILE_MMAP)
+    if (m_data)
+        munmap(const_cast<std::uint8_t *>(m_data), m_size);
+#endif
+}
+
+bool MappedFile::isOpen() const { return m_isOpen; }
+
+std::span<const std::uint8_t> MappedFile::getBytes() const
+{
+    return std::span<const std::uint8_t>{m_data, m_data ? m_size : 0};
+}
+
+std::size_t MappedFile::getSize() const { return m_size; }
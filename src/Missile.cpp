@@ -9,4 +9,7 @@ void Missile::setMissileSpeed(float speed) { m_missileSpeed = speed; }
 float Missile::getMissileSpeed() const { return m_missileSpeed; }
 
 void Missile::setTargetPos(const Vector2 &position) { m_targetPos = position; }
-const Vector2 &Missile::getTargetPos() const { return m_targetPos; }
\ No newline at end of file
+const Vector2 &Missile::getTargetPos() const { return m_targetPos; }
+
+void Missile::setFaction(Faction faction) { m_faction = faction; }
+Faction Missile::getFaction() const { return m_faction; }
@@ -0,0 +1,518 @@
+#include "MissileStore.h"
+#include "Missile.h"
+#include <raylib.h>
+#include <raymath.h>
+#include <cmath>     // for std::sqrt, std::ceil, std::floor
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::int32_t, std::uint32_t
+#include <vector>    // for std::vector
+#include <algorithm> // for std::fill, std::push_heap, std::pop_heap, std::make_heap
+#include <span>      // for std::span
+#include <limits>    // for std::numeric_limits
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h> // for SSE/AVX intrinsics
+#endif
+
+/*
+    the SIMD and scalar paths must stay bit-identical.
+    that holds because:
+    - every operation is done in the same order
+      as getTravelled() and evaluateScalar()
+    - min and max are written as (b < a) ? b : a and
+      (b > a) ? b : a in the scalar path, which is
+      exactly what minps and maxps pick
+    - -ffp-contract=off (CMakeLists.txt) keeps the
+      compiler from fusing multiply + add into an FMA
+*/
+
+namespace
+{
+    // slide every surviving element down over the dead ones
+    template <typename T>
+    void compactArray(std::vector<T> &array, const std::vector<std::uint8_t> &dead)
+    {
+        std::size_t write{0};
+
+        for (std::size_t read{0}; read < array.size(); ++read)
+        {
+            if (!dead[read])
+                array[write++] = array[read];
+        }
+
+        array.resize(write);
+    }
+}
+
+MissileStore::MissileStore(std::size_t capacity, float topSpeed)
+    : m_slots{capacity},
+      m_topSpeed{topSpeed},
+      m_dead(capacity, 0)
+{
+    m_startX.reserve(capacity);
+    m_startY.reserve(capacity);
+    m_dirX.reserve(capacity);
+    m_dirY.reserve(capacity);
+    m_length.reserve(capacity);
+    m_targetX.reserve(capacity);
+    m_targetY.reserve(capacity);
+    m_speed.reserve(capacity);
+    m_rampTicks.reserve(capacity);
+    m_launchTick.reserve(capacity);
+    m_arrivalTick.reserve(capacity);
+    m_x.reserve(capacity);
+    m_y.reserve(capacity);
+
+    // erased missiles leave their entry behind, erase()
+    // keeps those to at most one per live missile
+    m_arrivals.reserve(capacity * 2);
+    m_arrived.reserve(capacity);
+}
+
+float MissileStore::getTravelled(float age, float speed, float rampTicks, float topSpeed)
+{
+    // a missile doesn't move before it's launched, nor on
+    // the first tick after, it only starts speeding up then
+    age = (1.0f > age) ? 1.0f : age;
+
+    // n ticks after launch it has moved 0 + speed + ... +
+    // (n - 1) * speed while speeding up, then topSpeed a tick
+    const float ramp{(rampTicks < age) ? rampTicks : age};
+
+    return speed * ramp * (ramp - 1.0f) * 0.5f + topSpeed * (age - ramp);
+}
+
+float MissileStore::getRampTicks(float speed, float topSpeed)
+{
+    // a missile that never speeds up never gets to top speed
+    if (!(speed > 0.0f))
+        return std::numeric_limits<float>::infinity();
+
+    // the first whole tick it would move topSpeed or more on
+    return std::ceil(topSpeed / speed);
+}
+
+std::uint64_t MissileStore::getArrivalAge(float length, float speed, float topSpeed)
+{
+    // a missile that never speeds up never arrives
+    if (speed <= 0.0f)
+        return std::numeric_limits<std::uint64_t>::max();
+
+    const float rampTicks{getRampTicks(speed, topSpeed)};
+
+    // solve the travelled distance for length...
+    const float rampDistance{speed * rampTicks * (rampTicks - 1.0f) * 0.5f};
+    const float age{length <= rampDistance
+                        ? 0.5f + std::sqrt(0.25f + 2.0f * length / speed)
+                        : rampTicks + (length - rampDistance) / topSpeed};
+
+    auto arrivalAge{static_cast<std::uint64_t>(std::ceil(age))};
+
+    // ...then nudge it so it agrees exactly with
+    // the float maths evaluate() does
+    while (getTravelled(static_cast<float>(arrivalAge), speed, rampTicks, topSpeed) < length)
+        ++arrivalAge;
+
+    while (arrivalAge > 0 && getTravelled(static_cast<float>(arrivalAge - 1), speed, rampTicks, topSpeed) >= length)
+        --arrivalAge;
+
+    return arrivalAge;
+}
+
+Handle MissileStore::push(const Missile &missile, std::uint64_t launchTick)
+{
+    const Handle handle{m_slots.insert()};
+
+    if (!handle.isValid())
+    {
+        ++m_overflowCount;
+        return handle;
+    }
+
+    const Vector2 &start{missile.getStartPos()};
+    const Vector2 &target{missile.getTargetPos()};
+    const float length{Vector2Distance(start, target)};
+    const Vector2 direction{Vector2Normalize(Vector2Subtract(target, start))};
+    const float speed{missile.getMissileSpeed()};
+    const float rampTicks{getRampTicks(speed, m_topSpeed)};
+
+    // the first whole tick on which the missile has
+    // travelled the full length of its path
+    const std::uint64_t arrivalAge{speed > 0.0f
+                                       ? getArrivalAge(length, speed, m_topSpeed)
+                                       : std::numeric_limits<std::uint64_t>::max() - launchTick};
+
+    m_startX.push_back(start.x);
+    m_startY.push_back(start.y);
+    m_dirX.push_back(direction.x);
+    m_dirY.push_back(direction.y);
+    m_length.push_back(length);
+    m_targetX.push_back(target.x);
+    m_targetY.push_back(target.y);
+    m_speed.push_back(speed);
+    m_rampTicks.push_back(rampTicks);
+    m_launchTick.push_back(static_cast<std::uint32_t>(launchTick));
+    m_arrivalTick.push_back(launchTick + arrivalAge);
+    m_x.push_back(start.x);
+    m_y.push_back(start.y);
+
+    // the earliest arrival sits on top of the heap
+    // a missile that never arrives has no business in it
+    if (speed > 0.0f)
+    {
+        m_arrivals.push_back(Arrival{launchTick + arrivalAge, handle});
+        std::push_heap(m_arrivals.begin(), m_arrivals.end(), arrivesLater);
+    }
+
+    return handle;
+}
+
+bool MissileStore::erase(const Handle &handle)
+{
+    const Handle handles[]{handle};
+    const bool alive{m_slots.contains(handle)};
+
+    erase(std::span<const Handle>{handles});
+
+    return alive;
+}
+
+void MissileStore::erase(std::span<const Handle> handles)
+{
+    bool anyDead{false};
+
+    for (const Handle &handle : handles)
+    {
+        const std::size_t index{m_slots.find(handle)};
+
+        if (index != SlotMap::npos)
+        {
+            m_dead[index] = 1;
+            anyDead = true;
+        }
+    }
+
+    if (!anyDead)
+        return;
+
+    const std::size_t count{size()};
+
+    m_slots.compact(std::span<const std::uint8_t>{m_dead.data(), count});
+
+    compactArray(m_startX, m_dead);
+    compactArray(m_startY, m_dead);
+    compactArray(m_dirX, m_dead);
+    compactArray(m_dirY, m_dead);
+    compactArray(m_length, m_dead);
+    compactArray(m_targetX, m_dead);
+    compactArray(m_targetY, m_dead);
+    compactArray(m_speed, m_dead);
+    compactArray(m_rampTicks, m_dead);
+    compactArray(m_launchTick, m_dead);
+    compactArray(m_arrivalTick, m_dead);
+    compactArray(m_x, m_dead);
+    compactArray(m_y, m_dead);
+
+    // reset only the flags that were used
+    std::fill(m_dead.begin(), m_dead.begin() + static_cast<std::ptrdiff_t>(count), 0);
+
+    // once the erased missiles' entries outnumber the live
+    // missiles start the heap over. it never holds more than
+    // twice the missiles, so it stays inside its reservation,
+    // and the rebuild is paid for by the erases that led to it
+    if (m_arrivals.size() > size() * 2)
+        rebuildArrivals();
+}
+
+void MissileStore::rebuildArrivals()
+{
+    m_arrivals.clear();
+
+    for (std::size_t index{0}; index < size(); ++index)
+    {
+        if (m_speed[index] > 0.0f)
+            m_arrivals.push_back(Arrival{m_arrivalTick[index], getHandle(index)});
+    }
+
+    std::make_heap(m_arrivals.begin(), m_arrivals.end(), arrivesLater);
+}
+
+void MissileStore::clear()
+{
+    m_slots.clear();
+    m_startX.clear();
+    m_startY.clear();
+    m_dirX.clear();
+    m_dirY.clear();
+    m_length.clear();
+    m_targetX.clear();
+    m_targetY.clear();
+    m_speed.clear();
+    m_rampTicks.clear();
+    m_launchTick.clear();
+    m_arrivalTick.clear();
+    m_x.clear();
+    m_y.clear();
+    m_arrivals.clear();
+    m_arrived.clear();
+}
+
+std::size_t MissileStore::size() const { return m_x.size(); }
+bool MissileStore::empty() const { return m_x.empty(); }
+std::size_t MissileStore::getCapacity() const { return m_slots.getCapacity(); }
+std::uint64_t MissileStore::getOverflowCount() const { return m_overflowCount; }
+
+std::size_t MissileStore::getReservedBytes() const
+{
+    const std::size_t floats{m_startX.capacity() + m_startY.capacity() +
+                             m_dirX.capacity() + m_dirY.capacity() + m_length.capacity() +
+                             m_targetX.capacity() + m_targetY.capacity() +
+                             m_speed.capacity() + m_rampTicks.capacity() +
+                             m_x.capacity() + m_y.capacity()};
+
+    return m_slots.getReservedBytes() + m_dead.capacity() +
+           floats * sizeof(float) +
+           m_launchTick.capacity() * sizeof(std::uint32_t) +
+           m_arrivalTick.capacity() * sizeof(std::uint64_t) +
+           m_arrivals.capacity() * sizeof(Arrival) +
+           m_arrived.capacity() * sizeof(Handle);
+}
+float MissileStore::getTopSpeed() const { return m_topSpeed; }
+
+Handle MissileStore::getHandle(std::size_t index) const { return m_slots.getHandle(index); }
+std::size_t MissileStore::find(const Handle &handle) const { return m_slots.find(handle); }
+
+Vector2 MissileStore::getStartPos(std::size_t index) const { return Vector2{m_startX[index], m_startY[index]}; }
+Vector2 MissileStore::getTargetPos(std::size_t index) const { return Vector2{m_targetX[index], m_targetY[index]}; }
+float MissileStore::getMissileSpeed(std::size_t index) const { return m_speed[index]; }
+std::uint64_t MissileStore::getArrivalTick(std::size_t index) const { return m_arrivalTick[index]; }
+
+Vector2 MissileStore::getDirection(std::size_t index) const { return Vector2{m_dirX[index], m_dirY[index]}; }
+float MissileStore::getLength(std::size_t index) const { return m_length[index]; }
+float MissileStore::getRampTicks(std::size_t index) const { return m_rampTicks[index]; }
+
+float MissileStore::getAge(std::size_t index, double tick) const
+{
+    // there is no tick before 0 (and casting a negative
+    // double to an unsigned integer is undefined)
+    tick = (0.0 > tick) ? 0.0 : tick;
+
+    // whole ticks since launch, wrapped the same way evaluate() does
+    const double wholeTick{std::floor(tick)};
+    const auto wholeAge{static_cast<std::int32_t>(static_cast<std::uint32_t>(static_cast<std::uint64_t>(wholeTick)) - m_launchTick[index])};
+
+    return static_cast<float>(wholeAge) + static_cast<float>(tick - wholeTick);
+}
+
+Vector2 MissileStore::getEndPos(std::size_t index) const { return Vector2{m_x[index], m_y[index]}; }
+
+Vector2 MissileStore::getEndPos(std::size_t index, double tick) const
+{
+    const float age{getAge(index, tick)};
+    const float travelled{getTravelled(age, m_speed[index], m_rampTicks[index], m_topSpeed)};
+
+    if (travelled >= m_length[index])
+        return getTargetPos(index);
+
+    return Vector2{
+        m_startX[index] + m_dirX[index] * travelled,
+        m_startY[index] + m_dirY[index] * travelled,
+    };
+}
+
+Vector2 MissileStore::getEndPosOnTick(std::size_t index, std::uint64_t tick) const
+{
+    return evaluateScalar(static_cast<std::uint32_t>(tick), index);
+}
+
+void MissileStore::evaluate(std::uint64_t tick)
+{
+    evaluate(tick, 0, size());
+}
+
+void MissileStore::evaluate(std::uint64_t tick, std::size_t first, std::size_t last)
+{
+    const std::size_t count{last};
+    const auto tick32{static_cast<std::uint32_t>(tick)};
+    std::size_t i{first};
+
+#if defined(__AVX2__)
+    const __m256i tick8{_mm256_set1_epi32(static_cast<int>(tick32))};
+    const __m256 one8{_mm256_set1_ps(1.0f)};
+    const __m256 half8{_mm256_set1_ps(0.5f)};
+    const __m256 maxD8{_mm256_set1_ps(m_topSpeed)};
+
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i launch{_mm256_loadu_si256(reinterpret_cast<const __m256i *>(m_launchTick.data() + i))};
+        const __m256 age{_mm256_max_ps(one8, _mm256_cvtepi32_ps(_mm256_sub_epi32(tick8, launch)))};
+        const __m256 speed{_mm256_loadu_ps(m_speed.data() + i)};
+        const __m256 ramp{_mm256_min_ps(_mm256_loadu_ps(m_rampTicks.data() + i), age)};
+        const __m256 length{_mm256_loadu_ps(m_length.data() + i)};
+
+        const __m256 travelled{_mm256_add_ps(
+            _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(speed, ramp), _mm256_sub_ps(ramp, one8)), half8),
+            _mm256_mul_ps(maxD8, _mm256_sub_ps(age, ramp)))};
+
+        const __m256 arrived{_mm256_cmp_ps(travelled, length, _CMP_GE_OQ)};
+
+        const __m256 x{_mm256_add_ps(_mm256_loadu_ps(m_startX.data() + i), _mm256_mul_ps(_mm256_loadu_ps(m_dirX.data() + i), travelled))};
+        const __m256 y{_mm256_add_ps(_mm256_loadu_ps(m_startY.data() + i), _mm256_mul_ps(_mm256_loadu_ps(m_dirY.data() + i), travelled))};
+
+        _mm256_storeu_ps(m_x.data() + i, _mm256_blendv_ps(x, _mm256_loadu_ps(m_targetX.data() + i), arrived));
+        _mm256_storeu_ps(m_y.data() + i, _mm256_blendv_ps(y, _mm256_loadu_ps(m_targetY.data() + i), arrived));
+    }
+#endif
+
+#if defined(__SSE2__)
+    const __m128i tick4{_mm_set1_epi32(static_cast<int>(tick32))};
+    const __m128 one4{_mm_set1_ps(1.0f)};
+    const __m128 half4{_mm_set1_ps(0.5f)};
+    const __m128 maxD4{_mm_set1_ps(m_topSpeed)};
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i launch{_mm_loadu_si128(reinterpret_cast<const __m128i *>(m_launchTick.data() + i))};
+        const __m128 age{_mm_max_ps(one4, _mm_cvtepi32_ps(_mm_sub_epi32(tick4, launch)))};
+        const __m128 speed{_mm_loadu_ps(m_speed.data() + i)};
+        const __m128 ramp{_mm_min_ps(_mm_loadu_ps(m_rampTicks.data() + i), age)};
+        const __m128 length{_mm_loadu_ps(m_length.data() + i)};
+
+        const __m128 travelled{_mm_add_ps(
+            _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(speed, ramp), _mm_sub_ps(ramp, one4)), half4),
+            _mm_mul_ps(maxD4, _mm_sub_ps(age, ramp)))};
+
+        const __m128 arrived{_mm_cmpge_ps(travelled, length)};
+
+        const __m128 x{_mm_add_ps(_mm_loadu_ps(m_startX.data() + i), _mm_mul_ps(_mm_loadu_ps(m_dirX.data() + i), travelled))};
+        const __m128 y{_mm_add_ps(_mm_loadu_ps(m_startY.data() + i), _mm_mul_ps(_mm_loadu_ps(m_dirY.data() + i), travelled))};
+
+        // SSE2 has no blend, so select with and/andnot/or
+        const __m128 targetX{_mm_loadu_ps(m_targetX.data() + i)};
+        const __m128 targetY{_mm_loadu_ps(m_targetY.data() + i)};
+
+        _mm_storeu_ps(m_x.data() + i, _mm_or_ps(_mm_and_ps(arrived, targetX), _mm_andnot_ps(arrived, x)));
+        _mm_storeu_ps(m_y.data() + i, _mm_or_ps(_mm_and_ps(arrived, targetY), _mm_andnot_ps(arrived, y)));
+    }
+#endif
+
+    // whatever doesn't fill a whole register
+    evaluateScalar(tick32, i, count);
+}
+
+void MissileStore::evaluateScalar(std::uint64_t tick)
+{
+    evaluateScalar(static_cast<std::uint32_t>(tick), 0, size());
+}
+
+void MissileStore::evaluateScalar(std::uint32_t tick, std::size_t first, std::size_t last)
+{
+    for (std::size_t i{first}; i < last; ++i)
+    {
+        const Vector2 position{evaluateScalar(tick, i)};
+
+        m_x[i] = position.x;
+        m_y[i] = position.y;
+    }
+}
+
+Vector2 MissileStore::evaluateScalar(std::uint32_t tick, std::size_t index) const
+{
+    const float age{static_cast<float>(static_cast<std::int32_t>(tick - m_launchTick[index]))};
+    const float travelled{getTravelled(age, m_speed[index], m_rampTicks[index], m_topSpeed)};
+
+    if (travelled >= m_length[index])
+        return Vector2{m_targetX[index], m_targetY[index]};
+
+    return Vector2{
+        m_startX[index] + m_dirX[index] * travelled,
+        m_startY[index] + m_dirY[index] * travelled,
+    };
+}
+
+bool MissileStore::arrivesLater(const Arrival &a, const Arrival &b)
+{
+    // ties are broken by slot so the order never depends
+    // on how the standard library builds its heap
+    return a.tick > b.tick || (a.tick == b.tick && a.handle.slot > b.handle.slot);
+}
+
+std::span<const Handle> MissileStore::collectArrivals(std::uint64_t tick)
+{
+    m_arrived.clear();
+
+    // pop every arrival that is due, O(log n) each
+    while (!m_arrivals.empty() && m_arrivals.front().tick <= tick)
+    {
+        std::pop_heap(m_arrivals.begin(), m_arrivals.end(), arrivesLater);
+
+        // skip missiles that were erased before they arrived
+        if (m_slots.contains(m_arrivals.back().handle))
+            m_arrived.push_back(m_arrivals.back().handle);
+
+        m_arrivals.pop_back();
+    }
+
+    return m_arrived;
+}
+
+void MissileStore::saveState(ByteWriter &writer) const
+{
+    m_slots.saveState(writer);
+    writer.writeVarint(m_overflowCount);
+
+    writer.writeArray(std::span{m_startX});
+    writer.writeArray(std::span{m_startY});
+    writer.writeArray(std::span{m_dirX});
+    writer.writeArray(std::span{m_dirY});
+    writer.writeArray(std::span{m_length});
+    writer.writeArray(std::span{m_targetX});
+    writer.writeArray(std::span{m_targetY});
+    writer.writeArray(std::span{m_speed});
+    writer.writeArray(std::span{m_rampTicks});
+    writer.writeArray(std::span{m_launchTick});
+    writer.writeArray(std::span{m_arrivalTick});
+    writer.writeArray(std::span{m_x});
+    writer.writeArray(std::span{m_y});
+    writer.writeArray(std::span{m_arrivals});
+}
+
+bool MissileStore::restoreState(ByteReader &reader)
+{
+    const bool slotsRestored{m_slots.restoreState(reader)};
+    const std::size_t capacity{getCapacity()};
+
+    m_overflowCount = reader.readVarint();
+
+    reader.readArray(m_startX, capacity);
+    reader.readArray(m_startY, capacity);
+    reader.readArray(m_dirX, capacity);
+    reader.readArray(m_dirY, capacity);
+    reader.readArray(m_length, capacity);
+    reader.readArray(m_targetX, capacity);
+    reader.readArray(m_targetY, capacity);
+    reader.readArray(m_speed, capacity);
+    reader.readArray(m_rampTicks, capacity);
+    reader.readArray(m_launchTick, capacity);
+    reader.readArray(m_arrivalTick, capacity);
+    reader.readArray(m_x, capacity);
+    reader.readArray(m_y, capacity);
+
+    // the heap also holds entries of erased missiles,
+    // at most as many as there are live missiles
+    reader.readArray(m_arrivals, capacity * 2);
+
+    m_arrived.clear();
+
+    const std::size_t count{m_slots.size()};
+
+    return slotsRestored && !reader.hasFailed() &&
+           m_startX.size() == count && m_startY.size() == count &&
+           m_dirX.size() == count && m_dirY.size() == count &&
+           m_length.size() == count &&
+           m_targetX.size() == count && m_targetY.size() == count &&
+           m_speed.size() == count && m_rampTicks.size() == count &&
+           m_launchTick.size() == count && m_arrivalTick.size() == count &&
+           m_x.size() == count && m_y.size() == count &&
+           m_arrivals.size() <= count * 2;
+}
@@ -0,0 +1,178 @@
+#include "Profiler.h"
+#include <array>       // for std::array
+#include <atomic>      // for std::atomic, std::atomic_thread_fence
+#include <chrono>      // for std::chrono::steady_clock
+#include <fstream>     // for std::ofstream
+#include <iomanip>     // for std::setprecision
+#include <algorithm>   // for std::sort, std::min
+#include <string_view> // for std::string_view
+
+namespace
+{
+    // a power of two, about a second of
+    // samples of a busy 60 ticks per second game
+    constexpr std::size_t ringSize{1 << 14};
+
+    // every field is atomic, so a sample being read while it's
+    // overwritten is never undefined behaviour, just rejected
+    // by the sequence check in collect()
+    struct Slot
+    {
+        // 0 while being written, index + 1 once complete
+        std::atomic<std::uint64_t> sequence{};
+
+        std::atomic<const char *> name{};
+        std::atomic<std::uint64_t> startNs{};
+        std::atomic<std::uint64_t> durationNs{};
+        std::atomic<std::uint32_t> thread{};
+    };
+
+    std::array<Slot, ringSize> g_slots{};
+
+    // total samples ever recorded
+    std::atomic<std::uint64_t> g_head{};
+
+    std::atomic<std::uint32_t> g_nextThread{};
+
+    // a small id per thread, in the order threads first record
+    std::uint32_t getThreadId()
+    {
+        thread_local const std::uint32_t id{g_nextThread.fetch_add(1, std::memory_order_relaxed)};
+        return id;
+    }
+
+    // samples are grouped by name, not by pointer, because the
+    // same literal can live at two addresses in two files
+    bool isSameName(const char *a, const char *b)
+    {
+        return std::string_view{a} == std::string_view{b};
+    }
+}
+
+namespace Profiler
+{
+    std::uint64_t now()
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              std::chrono::steady_clock::now().time_since_epoch())
+                                              .count());
+    }
+
+    void record(const char *name, std::uint64_t startNs, std::uint64_t durationNs)
+    {
+        const std::uint64_t index{g_head.fetch_add(1, std::memory_order_relaxed)};
+        Slot &slot{g_slots[index & (ringSize - 1)]};
+
+        // a seqlock: mark the slot busy, fill it, mark it done
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.startNs.store(startNs, std::memory_order_relaxed);
+        slot.durationNs.store(durationNs, std::memory_order_relaxed);
+        slot.thread.store(getThreadId(), std::memory_order_relaxed);
+
+        slot.sequence.store(index + 1, std::memory_order_release);
+    }
+
+    void collect(std::vector<Sample> &samples)
+    {
+        samples.clear();
+
+        const std::uint64_t head{g_head.load(std::memory_order_acquire)};
+        const std::uint64_t first{head > ringSize ? head - ringSize : 0};
+
+        for (std::uint64_t index{first}; index < head; ++index)
+        {
+            const Slot &slot{g_slots[index & (ringSize - 1)]};
+
+            // still being written, or already overwritten
+            if (slot.sequence.load(std::memory_order_acquire) != index + 1)
+                continue;
+
+            Sample sample{};
+            sample.name = slot.name.load(std::memory_order_relaxed);
+            sample.startNs = slot.startNs.load(std::memory_order_relaxed);
+            sample.durationNs = slot.durationNs.load(std::memory_order_relaxed);
+            sample.thread = slot.thread.load(std::memory_order_relaxed);
+
+            // overwritten while we were copying it
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.sequence.load(std::memory_order_relaxed) != index + 1)
+                continue;
+
+            samples.push_back(sample);
+        }
+    }
+
+    void computeStats(std::vector<Sample> &samples, std::vector<PhaseStats> &stats)
+    {
+        stats.clear();
+
+        // group by name, shortest first within a group
+        std::sort(samples.begin(), samples.end(), [](const Sample &a, const Sample &b)
+                  {
+                      const std::string_view nameA{a.name};
+                      const std::string_view nameB{b.name};
+                      return nameA != nameB ? nameA < nameB : a.durationNs < b.durationNs; });
+
+        std::size_t first{0};
+
+        while (first < samples.size())
+        {
+            std::size_t last{first + 1};
+
+            while (last < samples.size() && isSameName(samples[first].name, samples[last].name))
+                ++last;
+
+            const std::size_t count{last - first};
+
+            // the sample at a fraction of the way through the group
+            const auto percentile{[&](double fraction)
+                                  {
+                                      const auto offset{static_cast<std::size_t>(fraction * static_cast<double>(count - 1))};
+                                      return static_cast<double>(samples[first + offset].durationNs) / 1e6;
+                                  }};
+
+            stats.push_back(PhaseStats{samples[first].name, count, percentile(0.5), percentile(0.99)});
+
+            first = last;
+        }
+    }
+
+    bool exportChromeTrace(std::span<const Sample> samples, const std::string &path)
+    {
+        std::ofstream out{path};
+
+        if (!out)
+            return false;
+
+        // times are microseconds since the oldest sample
+        // (too big for a double's digits otherwise)
+        std::uint64_t origin{samples.empty() ? 0 : samples.front().startNs};
+
+        for (const Sample &sample : samples)
+            origin = std::min(origin, sample.startNs);
+
+        out << std::fixed << std::setprecision(3);
+
+        // complete events ("ph": "X")
+        out << "{\"traceEvents\": [\n";
+
+        for (std::size_t i{0}; i < samples.size(); ++i)
+        {
+            const Sample &sample{samples[i]};
+
+            out << "  {\"name\": \"" << sample.name
+                << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << sample.thread
+                << ", \"ts\": " << static_cast<double>(sample.startNs - origin) / 1e3
+                << ", \"dur\": " << static_cast<double>(sample.durationNs) / 1e3
+                << (i + 1 < samples.size() ? "},\n" : "}\n");
+        }
+
+        out << "]}\n";
+
+        return static_cast<bool>(out);
+    }
+}
@@ -0,0 +1,134 @@
+#include "ReplayReader.h"
+#include "ReplayFormat.h"
+#include "Scenario.h"
+#include <algorithm> // for std::equal
+#include <limits>    // for std::numeric_limits
+
+ReplayReader::ReplayReader(std::span<const std::uint8_t> bytes)
+    : m_reader{bytes}
+{
+    const std::span<const std::uint8_t> magic{m_reader.readBytes(ReplayFormat::magic.size())};
+
+    if (!std::equal(magic.begin(), magic.end(), ReplayFormat::magic.begin(), ReplayFormat::magic.end()))
+        return;
+
+    if (m_reader.readU8() != ReplayFormat::version)
+        return;
+
+    m_config = World::readConfig(m_reader);
+    m_hashInterval = static_cast<std::uint32_t>(m_reader.readVarint());
+
+    if (m_reader.hasFailed() || m_hashInterval == 0 || m_config.tickRate <= 0.0f)
+        return;
+
+    // a world can't be built on a scenario that doesn't load
+    if (!m_config.scenario.empty() && !ScenarioView{m_config.scenario, m_config.width, m_config.height}.isValid())
+        return;
+
+    m_valid = true;
+
+    readRecord();
+}
+
+bool ReplayReader::isValid() const { return m_valid; }
+
+const WorldConfig &ReplayReader::getConfig() const { return m_config; }
+std::uint32_t ReplayReader::getHashInterval() const { return m_hashInterval; }
+
+bool ReplayReader::readTick(ReplayTick &tick)
+{
+    if (!m_valid || m_failed)
+        return false;
+
+    tick = ReplayTick{};
+
+    // every record of this tick, the end record
+    // is never consumed so it keeps returning false
+    while (m_recordTick == m_tick && m_recordKind != static_cast<std::uint8_t>(ReplayFormat::Record::end))
+    {
+        switch (static_cast<ReplayFormat::Record>(m_recordKind))
+        {
+        case ReplayFormat::Record::firePixel:
+        case ReplayFormat::Record::fireExact:
+            tick.input.fire = true;
+            tick.input.target = m_recordTarget;
+            break;
+
+        case ReplayFormat::Record::hash:
+            tick.hasHash = true;
+            tick.hash = m_recordHash;
+            break;
+
+        case ReplayFormat::Record::enemies:
+            tick.input.enemies = m_recordEnemies;
+            break;
+
+        case ReplayFormat::Record::end:
+            break;
+        }
+
+        readRecord();
+
+        if (m_failed)
+            return false;
+    }
+
+    if (m_recordTick == m_tick && m_recordKind == static_cast<std::uint8_t>(ReplayFormat::Record::end))
+        return false;
+
+    ++m_tick;
+    return true;
+}
+
+bool ReplayReader::hasFailed() const { return m_failed; }
+
+std::uint64_t ReplayReader::getTick() const { return m_tick; }
+
+void ReplayReader::readRecord()
+{
+    const std::uint64_t header{m_reader.readVarint()};
+
+    m_recordTick += header >> ReplayFormat::kindBits;
+    m_recordKind = static_cast<std::uint8_t>(header & ((1u << ReplayFormat::kindBits) - 1));
+
+    switch (static_cast<ReplayFormat::Record>(m_recordKind))
+    {
+    case ReplayFormat::Record::firePixel:
+        m_lastX += m_reader.readZigzag();
+        m_lastY += m_reader.readZigzag();
+        m_recordTarget = Vector2{static_cast<float>(m_lastX), static_cast<float>(m_lastY)};
+        break;
+
+    case ReplayFormat::Record::fireExact:
+        m_recordTarget.x = m_reader.readFloat();
+        m_recordTarget.y = m_reader.readFloat();
+        break;
+
+    case ReplayFormat::Record::hash:
+        m_recordHash = m_reader.readU32();
+        break;
+
+    case ReplayFormat::Record::enemies:
+    {
+        const std::uint64_t enemies{m_reader.readVarint()};
+        m_recordEnemies = static_cast<std::uint32_t>(enemies);
+
+        if (enemies > std::numeric_limits<std::uint32_t>::max())
+            m_failed = true;
+
+        break;
+    }
+
+    case ReplayFormat::Record::end:
+        break;
+
+    default:
+        // a kind this version doesn't know
+        m_failed = true;
+        break;
+    }
+
+    // a file cut short, or records out of order
+    if (m_reader.hasFailed() || m_recordTick < m_tick)
+        m_failed = true;
+}
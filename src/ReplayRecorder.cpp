@@ -0,0 +1,123 @@
+#include "ReplayRecorder.h"
+#include "ReplayFormat.h"
+#include "ByteStream.h"
+#include <cmath>     // for std::floor, std::fabs
+#include <algorithm> // for std::max
+
+namespace
+{
+    // the buffer is written out once it gets this big
+    constexpr std::size_t flushSize{64 * 1024};
+
+    // a target on a whole pixel no further than this from
+    // the origin is stored as a pixel delta
+    constexpr float maxPixel{1 << 24};
+
+    bool isPixel(float value)
+    {
+        return std::floor(value) == value && std::fabs(value) < maxPixel;
+    }
+}
+
+ReplayRecorder::ReplayRecorder(const std::string &path, const WorldConfig &config, std::uint32_t hashInterval)
+    : m_file{path, std::ios::binary},
+      m_hashInterval{std::max(1u, hashInterval)}
+{
+    m_buffer.reserve(flushSize * 2);
+
+    ByteWriter writer{m_buffer};
+
+    writer.writeBytes(ReplayFormat::magic);
+    writer.writeU8(ReplayFormat::version);
+    World::writeConfig(writer, config);
+    writer.writeVarint(m_hashInterval);
+}
+
+ReplayRecorder::~ReplayRecorder()
+{
+    finish();
+}
+
+bool ReplayRecorder::isOpen() const
+{
+    return static_cast<bool>(m_file);
+}
+
+void ReplayRecorder::recordTick(const InputFrame &input, const World &world)
+{
+    if (m_finished)
+        return;
+
+    ByteWriter writer{m_buffer};
+
+    if (input.fire)
+    {
+        if (isPixel(input.target.x) && isPixel(input.target.y))
+        {
+            const auto x{static_cast<std::int64_t>(input.target.x)};
+            const auto y{static_cast<std::int64_t>(input.target.y)};
+
+            writeRecord(static_cast<std::uint8_t>(ReplayFormat::Record::firePixel));
+            writer.writeZigzag(x - m_lastX);
+            writer.writeZigzag(y - m_lastY);
+
+            m_lastX = x;
+            m_lastY = y;
+        }
+        else
+        {
+            writeRecord(static_cast<std::uint8_t>(ReplayFormat::Record::fireExact));
+            writer.writeFloat(input.target.x);
+            writer.writeFloat(input.target.y);
+        }
+    }
+
+    if (input.enemies > 0)
+    {
+        writeRecord(static_cast<std::uint8_t>(ReplayFormat::Record::enemies));
+        writer.writeVarint(input.enemies);
+    }
+
+    // the world is only hashed on the ticks that keep a hash
+    if ((m_ticks + 1) % m_hashInterval == 0)
+    {
+        writeRecord(static_cast<std::uint8_t>(ReplayFormat::Record::hash));
+        writer.writeU32(static_cast<std::uint32_t>(world.getStateHash()));
+    }
+
+    ++m_ticks;
+
+    if (m_buffer.size() >= flushSize)
+        flush();
+}
+
+void ReplayRecorder::finish()
+{
+    if (m_finished)
+        return;
+
+    // records are stamped with m_ticks, which is the
+    // total tick count by now, just what the end record wants
+    writeRecord(static_cast<std::uint8_t>(ReplayFormat::Record::end));
+
+    flush();
+    m_file.close();
+
+    m_finished = true;
+}
+
+std::uint64_t ReplayRecorder::getTicks() const { return m_ticks; }
+
+void ReplayRecorder::writeRecord(std::uint8_t kind)
+{
+    ByteWriter writer{m_buffer};
+
+    writer.writeVarint(((m_ticks - m_recordTick) << ReplayFormat::kindBits) | kind);
+    m_recordTick = m_ticks;
+}
+
+void ReplayRecorder::flush()
+{
+    m_file.write(reinterpret_cast<const char *>(m_buffer.data()), static_cast<std::streamsize>(m_buffer.size()));
+    m_buffer.clear();
+}
@@ -0,0 +1,132 @@
+#include "RlglDrawBackend.h"
+#include "DrawList.h"
+#include <raylib.h>
+#include <rlgl.h>
+#include <span> // for std::span
+
+namespace
+{
+    // big enough that a circle of any radius the game
+    // draws still has a smooth (filtered) edge
+    constexpr int circleTextureSize{64};
+
+    // a colour is set only when it changes,
+    // the commands come sorted by colour
+    void setColour(const Color &tint, Color &current, bool &isSet)
+    {
+        if (isSet && ColorIsEqual(tint, current))
+            return;
+
+        rlColor4ub(tint.r, tint.g, tint.b, tint.a);
+        current = tint;
+        isSet = true;
+    }
+}
+
+RlglDrawBackend::RlglDrawBackend()
+{
+    Image disc{GenImageColor(circleTextureSize, circleTextureSize, BLANK)};
+    ImageDrawCircle(&disc, circleTextureSize / 2, circleTextureSize / 2, circleTextureSize / 2 - 1, WHITE);
+
+    m_circle = LoadTextureFromImage(disc);
+    SetTextureFilter(m_circle, TEXTURE_FILTER_BILINEAR);
+
+    UnloadImage(disc);
+}
+
+RlglDrawBackend::~RlglDrawBackend()
+{
+    UnloadTexture(m_circle);
+}
+
+void RlglDrawBackend::drawBatch(const DrawBatch &batch, std::span<const DrawCommand> commands)
+{
+    switch (batch.primitive)
+    {
+    case DrawPrimitive::line:
+        drawLines(commands);
+        break;
+
+    case DrawPrimitive::circle:
+        drawQuads(commands, m_circle, Rectangle{0.0f, 0.0f, static_cast<float>(m_circle.width), static_cast<float>(m_circle.height)});
+        break;
+
+    case DrawPrimitive::rectangle:
+        // the 1x1 white texture raylib draws its own shapes with
+        drawQuads(commands, GetShapesTexture(), GetShapesTextureRectangle());
+        break;
+    }
+}
+
+void RlglDrawBackend::drawLines(std::span<const DrawCommand> commands) const
+{
+    Color current{};
+    bool isSet{false};
+
+    // rlgl starts a new draw call on its own
+    // when its vertex buffer fills up
+    rlBegin(RL_LINES);
+
+    for (const DrawCommand &command : commands)
+    {
+        setColour(command.tint, current, isSet);
+
+        rlVertex2f(command.a.x, command.a.y);
+        rlVertex2f(command.b.x, command.b.y);
+    }
+
+    rlEnd();
+}
+
+void RlglDrawBackend::drawQuads(std::span<const DrawCommand> commands, const Texture2D &texture, const Rectangle &source) const
+{
+    const auto width{static_cast<float>(texture.width)};
+    const auto height{static_cast<float>(texture.height)};
+
+    const float left{source.x / width};
+    const float right{(source.x + source.width) / width};
+    const float top{source.y / height};
+    const float bottom{(source.y + source.height) / height};
+
+    Color current{};
+    bool isSet{false};
+
+    rlSetTexture(texture.id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+
+    for (const DrawCommand &command : commands)
+    {
+        setColour(command.tint, current, isSet);
+
+        // a circle is the square around it
+        float x{command.a.x};
+        float y{command.a.y};
+        float w{command.b.x};
+        float h{command.b.y};
+
+        if (command.primitive == DrawPrimitive::circle)
+        {
+            x -= command.b.x;
+            y -= command.b.x;
+            w = command.b.x * 2.0f;
+            h = w;
+        }
+
+        // counter-clockwise, the order raylib uses
+        rlTexCoord2f(left, top);
+        rlVertex2f(x, y);
+
+        rlTexCoord2f(left, bottom);
+        rlVertex2f(x, y + h);
+
+        rlTexCoord2f(right, bottom);
+        rlVertex2f(x + w, y + h);
+
+        rlTexCoord2f(right, top);
+        rlVertex2f(x + w, y);
+    }
+
+    rlEnd();
+    rlSetTexture(0);
+}
@@ -0,0 +1,150 @@
+#include "Scenario.h"
+#include "ByteStream.h"
+#include <algorithm> // for std::equal, std::all_of
+#include <bit>       // for std::endian
+#include <cmath>     // for std::isfinite, std::abs
+#include <cstddef>   // for std::size_t
+
+namespace
+{
+    // every flag a header or a wave of this version can have
+    constexpr std::uint32_t headerFlags{ScenarioFormat::hasSeed};
+    constexpr std::uint32_t waveFlags{ScenarioFormat::waitForClearSky};
+
+    // the skyline only knows how high a building rises above the
+    // ground, one that floats would be a wall all the way down
+    bool isValidBuilding(const ScenarioFormat::Building &building, float worldWidth, float worldHeight)
+    {
+        return std::isfinite(building.x) && std::isfinite(building.y) &&
+               std::isfinite(building.width) && std::isfinite(building.height) &&
+               building.width > 0.0f && building.height > 0.0f &&
+               building.x >= -ScenarioFormat::fitTolerance &&
+               building.x + building.width <= worldWidth + ScenarioFormat::fitTolerance &&
+               std::abs(building.y + building.height - worldHeight) <= ScenarioFormat::fitTolerance;
+    }
+
+    bool isValidLaunchSite(const ScenarioFormat::LaunchSite &launchSite)
+    {
+        return std::isfinite(launchSite.minX) && std::isfinite(launchSite.maxX) && std::isfinite(launchSite.y) &&
+               launchSite.minX <= launchSite.maxX;
+    }
+
+    bool isValidWave(const ScenarioFormat::Wave &wave)
+    {
+        // the comparisons are false for NaN too
+        return wave.delaySeconds >= 0.0f && wave.delaySeconds <= ScenarioFormat::maxWaveSeconds &&
+               wave.spacingSeconds >= 0.0f && wave.spacingSeconds <= ScenarioFormat::maxWaveSeconds &&
+               wave.count <= ScenarioFormat::maxWaveCount &&
+               wave.perLaunch > 0 && (wave.flags & ~waveFlags) == 0;
+    }
+
+    // a section of count Ts starting offset bytes into bytes
+    template <typename T>
+    std::span<const T> getSection(std::span<const std::uint8_t> bytes, std::size_t offset, std::size_t count)
+    {
+        return std::span<const T>{reinterpret_cast<const T *>(bytes.data() + offset), count};
+    }
+}
+
+ScenarioView::ScenarioView(std::span<const std::uint8_t> bytes, float worldWidth, float worldHeight)
+{
+    // the structs are the bytes, which only
+    // works where they're laid out the same
+    if constexpr (std::endian::native != std::endian::little)
+        return;
+
+    if (bytes.size() < sizeof(ScenarioFormat::Header) ||
+        reinterpret_cast<std::uintptr_t>(bytes.data()) % ScenarioFormat::alignment != 0)
+        return;
+
+    const ScenarioFormat::Header &header{*reinterpret_cast<const ScenarioFormat::Header *>(bytes.data())};
+
+    if (!std::equal(header.magic.begin(), header.magic.end(), ScenarioFormat::magic.begin(), ScenarioFormat::magic.end()) ||
+        header.version != ScenarioFormat::version || (header.flags & ~headerFlags) != 0)
+        return;
+
+    // the counts are 32 bit, their sizes can't overflow 64 bits
+    const std::uint64_t buildingsOffset{sizeof(ScenarioFormat::Header)};
+    const std::uint64_t launchSitesOffset{buildingsOffset + std::uint64_t{header.buildingCount} * sizeof(ScenarioFormat::Building)};
+    const std::uint64_t wavesOffset{launchSitesOffset + std::uint64_t{header.launchSiteCount} * sizeof(ScenarioFormat::LaunchSite)};
+    const std::uint64_t size{wavesOffset + std::uint64_t{header.waveCount} * sizeof(ScenarioFormat::Wave)};
+
+    if (size != bytes.size())
+        return;
+
+    m_buildings = getSection<ScenarioFormat::Building>(bytes, static_cast<std::size_t>(buildingsOffset), header.buildingCount);
+    m_launchSites = getSection<ScenarioFormat::LaunchSite>(bytes, static_cast<std::size_t>(launchSitesOffset), header.launchSiteCount);
+    m_waves = getSection<ScenarioFormat::Wave>(bytes, static_cast<std::size_t>(wavesOffset), header.waveCount);
+
+    const auto fitsWorld{[worldWidth, worldHeight](const ScenarioFormat::Building &building)
+                         { return isValidBuilding(building, worldWidth, worldHeight); }};
+
+    if (!std::all_of(m_buildings.begin(), m_buildings.end(), fitsWorld) ||
+        !std::all_of(m_launchSites.begin(), m_launchSites.end(), isValidLaunchSite) ||
+        !std::all_of(m_waves.begin(), m_waves.end(), isValidWave))
+    {
+        *this = ScenarioView{};
+        return;
+    }
+
+    if (header.flags & ScenarioFormat::hasSeed)
+        m_seed = header.seed;
+
+    m_valid = true;
+}
+
+bool ScenarioView::isValid() const { return m_valid; }
+
+std::optional<std::uint64_t> ScenarioView::getSeed() const { return m_seed; }
+
+std::span<const ScenarioFormat::Building> ScenarioView::getBuildings() const { return m_buildings; }
+std::span<const ScenarioFormat::LaunchSite> ScenarioView::getLaunchSites() const { return m_launchSites; }
+std::span<const ScenarioFormat::Wave> ScenarioView::getWaves() const { return m_waves; }
+
+void ScenarioBuilder::setSeed(std::uint64_t seed) { m_seed = seed; }
+
+void ScenarioBuilder::addBuilding(const ScenarioFormat::Building &building) { m_buildings.push_back(building); }
+void ScenarioBuilder::addLaunchSite(const ScenarioFormat::LaunchSite &launchSite) { m_launchSites.push_back(launchSite); }
+void ScenarioBuilder::addWave(const ScenarioFormat::Wave &wave) { m_waves.push_back(wave); }
+
+void ScenarioBuilder::write(std::vector<std::uint8_t> &bytes) const
+{
+    bytes.clear();
+
+    // field by field in the file's byte order, whatever the
+    // machine writing it, in the order the structs have them
+    ByteWriter writer{bytes};
+
+    writer.writeBytes(ScenarioFormat::magic);
+    writer.writeU32(ScenarioFormat::version);
+    writer.writeU64(m_seed.value_or(0));
+    writer.writeU32(m_seed ? ScenarioFormat::hasSeed : 0);
+    writer.writeU32(static_cast<std::uint32_t>(m_buildings.size()));
+    writer.writeU32(static_cast<std::uint32_t>(m_launchSites.size()));
+    writer.writeU32(static_cast<std::uint32_t>(m_waves.size()));
+
+    for (const ScenarioFormat::Building &building : m_buildings)
+    {
+        writer.writeFloat(building.x);
+        writer.writeFloat(building.y);
+        writer.writeFloat(building.width);
+        writer.writeFloat(building.height);
+        writer.writeBytes(building.tint);
+    }
+
+    for (const ScenarioFormat::LaunchSite &launchSite : m_launchSites)
+    {
+        writer.writeFloat(launchSite.minX);
+        writer.writeFloat(launchSite.maxX);
+        writer.writeFloat(launchSite.y);
+    }
+
+    for (const ScenarioFormat::Wave &wave : m_waves)
+    {
+        writer.writeFloat(wave.delaySeconds);
+        writer.writeU32(wave.count);
+        writer.writeFloat(wave.spacingSeconds);
+        writer.writeU32(wave.perLaunch);
+        writer.writeU32(wave.flags);
+    }
+}
@@ -0,0 +1,110 @@
+#include "SimulationThread.h"
+#include "Profiler.h"
+#include <chrono>       // for std::chrono::steady_clock, std::chrono::duration
+
+SimulationThread::SimulationThread(const WorldConfig &config, int maxStepsPerFrame)
+    : m_world{config},
+      m_timestep{config.tickRate, maxStepsPerFrame}
+{
+}
+
+void SimulationThread::setJobSystem(JobSystem *jobs) { m_world.setJobSystem(jobs); }
+
+void SimulationThread::setRecorder(ReplayRecorder *recorder) { m_recorder = recorder; }
+void SimulationThread::setWaveDirector(WaveDirector *director) { m_director = director; }
+
+WorldMemory SimulationThread::getWorldMemory() const { return m_world.getMemory(); }
+
+void SimulationThread::start()
+{
+    // publish the starting world so the
+    // first frame has something to draw
+    publishSnapshot(getTime());
+
+    m_thread = std::jthread{[this](std::stop_token stopToken)
+                            { run(stopToken); }};
+}
+
+void SimulationThread::stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    m_thread.request_stop();
+    m_thread.join();
+}
+
+bool SimulationThread::pushInput(const InputFrame &input)
+{
+    return m_inputs.push(input);
+}
+
+const RenderSnapshot &SimulationThread::acquireSnapshot()
+{
+    m_snapshots.acquire();
+    return m_snapshots.getReadBuffer();
+}
+
+long long SimulationThread::getDroppedTicks() const
+{
+    return m_droppedTicks.load(std::memory_order_relaxed);
+}
+
+double SimulationThread::getTime()
+{
+    using Seconds = std::chrono::duration<double>;
+    return std::chrono::duration_cast<Seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SimulationThread::run(std::stop_token stopToken)
+{
+    double lastTime{getTime()};
+
+    while (!stopToken.stop_requested())
+    {
+        const double now{getTime()};
+        const int steps{m_timestep.advance(now - lastTime)};
+        lastTime = now;
+
+        for (int step{0}; step < steps; ++step)
+        {
+            // nothing queued simply means no input this tick
+            InputFrame input{};
+            m_inputs.pop(input);
+
+            // the director's launches ride along with the input,
+            // so the recorder keeps them like any click
+            if (m_director)
+                input.enemies += m_director->update(m_world);
+
+            m_world.step(input);
+
+            if (m_recorder)
+                m_recorder->recordTick(input, m_world);
+        }
+
+        m_droppedTicks.store(m_timestep.getDroppedTicks(), std::memory_order_relaxed);
+
+        // the time left over since the last tick
+        const double leftover{m_timestep.getAlpha() * m_timestep.getTickSeconds()};
+
+        if (steps > 0)
+            publishSnapshot(now - leftover);
+
+        // nothing to do until the next tick is due
+        std::this_thread::sleep_for(std::chrono::duration<double>{m_timestep.getTickSeconds() - leftover});
+    }
+}
+
+void SimulationThread::publishSnapshot(double tickTime)
+{
+    PROFILE_SCOPE("publishSnapshot");
+
+    RenderSnapshot &snapshot{m_snapshots.getWriteBuffer()};
+
+    m_world.fillSnapshot(snapshot);
+    snapshot.publishedAt = tickTime;
+    snapshot.tickSeconds = m_timestep.getTickSeconds();
+
+    m_snapshots.publish();
+}
@@ -0,0 +1,232 @@
+#include "Skyline.h"
+#include <raylib.h>
+#include <algorithm> // for std::max, std::min, std::fill, std::max_element, std::sort, std::lower_bound
+#include <cmath>     // for std::ceil, std::floor
+#include <cassert>   // for assert
+#include <span>      // for std::span
+#include <optional>  // for std::optional
+
+Skyline::Skyline(float width, float groundY, float columnWidth, std::size_t maxBuildings)
+    : m_groundY{groundY},
+      m_columnWidth{columnWidth}
+{
+    assert(columnWidth > 0.0f && "column width must be positive");
+
+    const auto columns{std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(width / columnWidth)))};
+
+    m_heights.assign(columns, 0.0f);
+    m_owners.assign(columns, Handle{});
+    m_footprints.reserve(maxBuildings);
+}
+
+void Skyline::addBuilding(const Handle &building, const Rectangle &rectangle)
+{
+    stamp(building, rectangle, getFirstColumn(rectangle), getLastColumn(rectangle));
+
+    // sorted once the first building is removed, a city
+    // added in any order doesn't shuffle the array around
+    m_footprints.push_back(Footprint{rectangle, building});
+    m_widest = std::max(m_widest, rectangle.width);
+    m_isSorted = false;
+}
+
+void Skyline::removeBuilding(const Handle &building, const Rectangle &rectangle)
+{
+    const std::size_t first{getFirstColumn(rectangle)};
+    const std::size_t last{getLastColumn(rectangle)};
+
+    // only the columns the building still owns are flattened
+    for (std::size_t column{first}; column <= last; ++column)
+    {
+        if (m_owners[column] == building)
+        {
+            m_heights[column] = 0.0f;
+            m_owners[column] = Handle{};
+        }
+    }
+
+    sortFootprints();
+
+    // whatever stood behind the removed building shows up again.
+    // nothing starting further left of its first column than the
+    // widest building can reach it, nothing starting past its
+    // last column either
+    const float left{static_cast<float>(first) * m_columnWidth - m_widest};
+    const float right{static_cast<float>(last + 1) * m_columnWidth};
+
+    auto footprint{std::lower_bound(m_footprints.begin(), m_footprints.end(), left,
+                                    [](const Footprint &candidate, float x)
+                                    { return candidate.rectangle.x < x; })};
+
+    for (; footprint != m_footprints.end() && footprint->rectangle.x < right; ++footprint)
+    {
+        if (footprint->building == building)
+        {
+            footprint->building = Handle{};
+            continue;
+        }
+
+        if (!footprint->building.isValid())
+            continue;
+
+        // a building that shares no column with it stamps nothing
+        const Rectangle &other{footprint->rectangle};
+        const std::size_t otherFirst{std::max(first, getFirstColumn(other))};
+        const std::size_t otherLast{std::min(last, getLastColumn(other))};
+
+        if (otherFirst <= otherLast)
+            stamp(footprint->building, other, otherFirst, otherLast);
+    }
+}
+
+Handle Skyline::getBuildingAt(const Vector2 &point) const
+{
+    const float x{std::floor(point.x / m_columnWidth)};
+
+    // nothing stands outside the city
+    if (x < 0.0f || x >= static_cast<float>(m_heights.size()))
+        return Handle{};
+
+    const auto column{static_cast<std::size_t>(x)};
+
+    // the roof of a column is m_groundY - height
+    // and the ground itself isn't part of any building
+    if (point.y < m_groundY - m_heights[column] || point.y >= m_groundY)
+        return Handle{};
+
+    return m_owners[column];
+}
+
+Handle Skyline::sweep(const Vector2 &from, const Vector2 &to, float &impact) const
+{
+    // above every roof the whole way, or under the ground
+    if (std::max(from.y, to.y) < m_groundY - m_tallest || std::min(from.y, to.y) >= m_groundY)
+        return Handle{};
+
+    // the columns the way crosses, clipped to the city
+    const float cityWidth{static_cast<float>(m_heights.size()) * m_columnWidth};
+    const float left{std::min(from.x, to.x)};
+    const float right{std::max(from.x, to.x)};
+
+    if (right < 0.0f || left >= cityWidth)
+        return Handle{};
+
+    const std::size_t first{getColumn(left)};
+    const std::size_t last{getColumn(right)};
+    const std::size_t count{last - first + 1};
+
+    // walked in the direction of travel, so the first column
+    // that is hit is also the one hit first
+    const bool isLeftward{to.x < from.x};
+
+    for (std::size_t step{0}; step < count; ++step)
+    {
+        const std::size_t column{isLeftward ? last - step : first + step};
+
+        if (!m_owners[column].isValid())
+            continue;
+
+        const Rectangle roof{static_cast<float>(column) * m_columnWidth, m_groundY - m_heights[column], m_columnWidth, m_heights[column]};
+
+        if (const std::optional<float> hit{Sweep::segmentRectangle(from, to, roof)})
+        {
+            impact = *hit;
+            return m_owners[column];
+        }
+    }
+
+    return Handle{};
+}
+
+std::size_t Skyline::getColumnCount() const { return m_heights.size(); }
+float Skyline::getColumnWidth() const { return m_columnWidth; }
+float Skyline::getColumnHeight(std::size_t column) const { return m_heights[column]; }
+
+void Skyline::clear()
+{
+    std::fill(m_heights.begin(), m_heights.end(), 0.0f);
+    std::fill(m_owners.begin(), m_owners.end(), Handle{});
+    m_tallest = 0.0f;
+
+    m_footprints.clear();
+    m_widest = 0.0f;
+    m_isSorted = true;
+}
+
+std::size_t Skyline::getColumn(float x) const
+{
+    // anything outside the city is kept in the border columns
+    const float column{std::floor(x / m_columnWidth)};
+    return static_cast<std::size_t>(std::clamp(column, 0.0f, static_cast<float>(m_heights.size() - 1)));
+}
+
+std::size_t Skyline::getFirstColumn(const Rectangle &rectangle) const
+{
+    return getColumn(rectangle.x);
+}
+
+std::size_t Skyline::getLastColumn(const Rectangle &rectangle) const
+{
+    // the right edge itself isn't part of the rectangle
+    const float column{std::ceil((rectangle.x + rectangle.width) / m_columnWidth) - 1.0f};
+    return static_cast<std::size_t>(std::clamp(column, static_cast<float>(getFirstColumn(rectangle)), static_cast<float>(m_heights.size() - 1)));
+}
+
+void Skyline::stamp(const Handle &building, const Rectangle &rectangle, std::size_t first, std::size_t last)
+{
+    const float height{m_groundY - rectangle.y};
+
+    m_tallest = std::max(m_tallest, height);
+
+    for (std::size_t column{first}; column <= last; ++column)
+    {
+        // the taller building is the one a falling missile hits
+        // on a tie the lower slot, so the owner doesn't depend
+        // on the order the buildings are stamped in
+        if (height > m_heights[column] ||
+            (height == m_heights[column] && m_owners[column].isValid() && building.slot < m_owners[column].slot))
+        {
+            m_heights[column] = height;
+            m_owners[column] = building;
+        }
+    }
+}
+
+void Skyline::sortFootprints()
+{
+    if (m_isSorted)
+        return;
+
+    std::sort(m_footprints.begin(), m_footprints.end(), [](const Footprint &a, const Footprint &b)
+              { return a.rectangle.x < b.rectangle.x; });
+
+    m_isSorted = true;
+}
+
+void Skyline::saveState(ByteWriter &writer) const
+{
+    writer.writeArray(std::span{m_heights});
+    writer.writeArray(std::span{m_owners});
+    writer.writeArray(std::span{m_footprints});
+}
+
+bool Skyline::restoreState(ByteReader &reader)
+{
+    const std::size_t columns{getColumnCount()};
+
+    reader.readArray(m_heights, columns);
+    reader.readArray(m_owners, columns);
+    reader.readArray(m_footprints, m_footprints.capacity());
+
+    m_tallest = m_heights.empty() ? 0.0f : *std::max_element(m_heights.begin(), m_heights.end());
+
+    m_widest = 0.0f;
+
+    for (const Footprint &footprint : m_footprints)
+        m_widest = std::max(m_widest, footprint.rectangle.width);
+
+    // the order they were saved in doesn't matter, see stamp()
+    m_isSorted = false;
+
+    return !reader.hasFailed() && m_heights.size() == columns && m_owners.size() == columns;
+}
@@ -0,0 +1,146 @@
+#include "SlotMap.h"
+#include <cassert> // for assert
+
+SlotMap::SlotMap(std::size_t capacity)
+    : m_generations(capacity, 0),
+      m_denseIndex(capacity, 0),
+      m_slots(capacity, 0),
+      m_freeSlots(capacity, 0)
+{
+    clear();
+}
+
+std::size_t SlotMap::getCapacity() const { return m_slots.size(); }
+
+std::size_t SlotMap::getReservedBytes() const
+{
+    return (m_generations.capacity() + m_denseIndex.capacity() + m_slots.capacity() + m_freeSlots.capacity()) * sizeof(std::uint32_t);
+}
+std::size_t SlotMap::size() const { return m_size; }
+bool SlotMap::full() const { return m_size == m_slots.size(); }
+
+Handle SlotMap::insert()
+{
+    // overflow policy: a full map refuses the new entity
+    // and the caller gets an invalid handle back
+    if (full())
+        return Handle{};
+
+    const std::uint32_t slot{m_freeSlots.back()};
+    m_freeSlots.pop_back();
+
+    m_denseIndex[slot] = static_cast<std::uint32_t>(m_size);
+    m_slots[m_size] = slot;
+    ++m_size;
+
+    return Handle{slot, m_generations[slot]};
+}
+
+std::size_t SlotMap::find(const Handle &handle) const
+{
+    if (!contains(handle))
+        return npos;
+
+    return m_denseIndex[handle.slot];
+}
+
+Handle SlotMap::getHandle(std::size_t index) const
+{
+    assert(index < m_size && "dense index out of range");
+
+    const std::uint32_t slot{m_slots[index]};
+    return Handle{slot, m_generations[slot]};
+}
+
+bool SlotMap::contains(const Handle &handle) const
+{
+    return handle.slot < m_generations.size() &&
+           m_generations[handle.slot] == handle.generation &&
+           m_denseIndex[handle.slot] < m_size &&
+           m_slots[m_denseIndex[handle.slot]] == handle.slot;
+}
+
+void SlotMap::eraseAt(std::size_t index)
+{
+    assert(index < m_size && "dense index out of range");
+
+    const std::uint32_t slot{m_slots[index]};
+    const std::size_t last{m_size - 1};
+
+    // move the last entity's slot into the hole
+    m_slots[index] = m_slots[last];
+    m_denseIndex[m_slots[index]] = static_cast<std::uint32_t>(index);
+    --m_size;
+
+    // every handle to the erased entity is now stale
+    ++m_generations[slot];
+    m_freeSlots.push_back(slot);
+}
+
+void SlotMap::compact(std::span<const std::uint8_t> dead)
+{
+    std::size_t write{0};
+
+    for (std::size_t read{0}; read < m_size; ++read)
+    {
+        const std::uint32_t slot{m_slots[read]};
+
+        if (dead[read])
+        {
+            // every handle to the erased entity is now stale
+            ++m_generations[slot];
+            m_freeSlots.push_back(slot);
+            continue;
+        }
+
+        m_slots[write] = slot;
+        m_denseIndex[slot] = static_cast<std::uint32_t>(write);
+        ++write;
+    }
+
+    m_size = write;
+}
+
+void SlotMap::clear()
+{
+    // handles to the entities alive right now must not
+    // become valid again once their slots are reused
+    for (std::size_t index{0}; index < m_size; ++index)
+        ++m_generations[m_slots[index]];
+
+    m_size = 0;
+
+    // hand out the lowest slots first
+    const std::size_t capacity{m_slots.size()};
+
+    m_freeSlots.clear();
+
+    for (std::size_t slot{capacity}; slot > 0; --slot)
+        m_freeSlots.push_back(static_cast<std::uint32_t>(slot - 1));
+}
+
+void SlotMap::saveState(ByteWriter &writer) const
+{
+    writer.writeArray(std::span{m_generations});
+    writer.writeArray(std::span{m_denseIndex});
+    writer.writeArray(std::span{m_slots});
+    writer.writeArray(std::span{m_freeSlots});
+    writer.writeVarint(m_size);
+}
+
+bool SlotMap::restoreState(ByteReader &reader)
+{
+    const std::size_t capacity{getCapacity()};
+
+    reader.readArray(m_generations, capacity);
+    reader.readArray(m_denseIndex, capacity);
+    reader.readArray(m_slots, capacity);
+    reader.readArray(m_freeSlots, capacity);
+    m_size = static_cast<std::size_t>(reader.readVarint());
+
+    return !reader.hasFailed() &&
+           m_generations.size() == capacity &&
+           m_denseIndex.size() == capacity &&
+           m_slots.size() == capacity &&
+           m_size + m_freeSlots.size() == capacity;
+}
@@ -0,0 +1,130 @@
+#include "SpatialGrid.h"
+#include <raylib.h>
+#include <algorithm> // for std::fill, std::clamp
+#include <cmath>     // for std::ceil, std::floor
+#include <cassert>   // for assert
+
+SpatialGrid::SpatialGrid(float width, float height, float cellSize)
+    : m_width{width},
+      m_height{height}
+{
+    setCellSize(cellSize);
+}
+
+void SpatialGrid::setCellSize(float cellSize)
+{
+    assert(cellSize > 0.0f && "cell size must be positive");
+
+    m_cellSize = cellSize;
+
+    // always keep at least one cell
+    m_columns = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(m_width / m_cellSize)));
+    m_rows = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(m_height / m_cellSize)));
+
+    m_cellStart.assign(m_columns * m_rows + 1, 0);
+
+    clear();
+}
+
+float SpatialGrid::getCellSize() const { return m_cellSize; }
+
+void SpatialGrid::clear()
+{
+    m_entries.clear();
+    m_cellItems.clear();
+    std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+}
+
+void SpatialGrid::reserve(std::size_t entries)
+{
+    m_entries.reserve(entries);
+    m_cellItems.reserve(entries);
+}
+
+void SpatialGrid::insert(std::uint32_t id, const Rectangle &bounds)
+{
+    const std::size_t firstColumn{getColumn(bounds.x)};
+    const std::size_t lastColumn{getColumn(bounds.x + bounds.width)};
+    const std::size_t firstRow{getRow(bounds.y)};
+    const std::size_t lastRow{getRow(bounds.y + bounds.height)};
+
+    for (std::size_t row{firstRow}; row <= lastRow; ++row)
+    {
+        for (std::size_t column{firstColumn}; column <= lastColumn; ++column)
+            m_entries.push_back(Entry{static_cast<std::uint32_t>(row * m_columns + column), id});
+    }
+}
+
+void SpatialGrid::build()
+{
+    // counting sort the entries by cell
+    // first count how many items land in every cell
+    std::fill(m_cellStart.begin(), m_cellStart.end(), 0);
+
+    for (const Entry &entry : m_entries)
+        ++m_cellStart[entry.cell + 1];
+
+    // then turn the counts into start offsets
+    for (std::size_t cell{1}; cell < m_cellStart.size(); ++cell)
+        m_cellStart[cell] += m_cellStart[cell - 1];
+
+    // and finally drop every id into its cell's range
+    // m_cellStart[cell] is used as the write cursor
+    // and ends up pointing at the next cell's start
+    m_cellItems.resize(m_entries.size());
+
+    for (const Entry &entry : m_entries)
+        m_cellItems[m_cellStart[entry.cell]++] = entry.id;
+
+    // shift the cursors back so every cell starts where it should
+    for (std::size_t cell{m_cellStart.size() - 1}; cell > 0; --cell)
+        m_cellStart[cell] = m_cellStart[cell - 1];
+
+    m_cellStart[0] = 0;
+}
+
+std::span<const std::uint32_t> SpatialGrid::query(const Vector2 &point)
+{
+    const std::span<const std::uint32_t> candidates{find(point)};
+
+    m_candidatePairs += candidates.size();
+
+    return candidates;
+}
+
+std::span<const std::uint32_t> SpatialGrid::find(const Vector2 &point) const
+{
+    const std::size_t cell{getRow(point.y) * m_columns + getColumn(point.x)};
+    const std::uint32_t first{m_cellStart[cell]};
+    const std::uint32_t last{m_cellStart[cell + 1]};
+
+    return std::span<const std::uint32_t>{m_cellItems.data() + first, last - first};
+}
+
+void SpatialGrid::addCandidatePairs(std::uint64_t pairs) { m_candidatePairs += pairs; }
+
+std::uint64_t SpatialGrid::getCandidatePairs() const { return m_candidatePairs; }
+void SpatialGrid::resetCandidatePairs() { m_candidatePairs = 0; }
+
+std::size_t SpatialGrid::getColumn(float x) const
+{
+    // anything outside the grid is kept in the border cells
+    const float column{std::floor(x / m_cellSize)};
+    return static_cast<std::size_t>(std::clamp(column, 0.0f, static_cast<float>(m_columns - 1)));
+}
+
+std::size_t SpatialGrid::getRow(float y) const
+{
+    const float row{std::floor(y / m_cellSize)};
+    return static_cast<std::size_t>(std::clamp(row, 0.0f, static_cast<float>(m_rows - 1)));
+}
+
+std::size_t SpatialGrid::clampColumn(long long column) const
+{
+    return static_cast<std::size_t>(std::clamp(column, 0ll, static_cast<long long>(m_columns - 1)));
+}
+
+std::size_t SpatialGrid::clampRow(long long row) const
+{
+    return static_cast<std::size_t>(std::clamp(row, 0ll, static_cast<long long>(m_rows - 1)));
+}
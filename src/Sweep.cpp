@@ -0,0 +1,103 @@
+#include "Sweep.h"
+#include <raylib.h>
+#include <cmath>     // for std::sqrt, std::copysign
+#include <algorithm> // for std::max, std::min, std::swap
+#include <optional>  // for std::optional
+
+namespace
+{
+    // narrow [enter, leave] down to the times the point is
+    // between low and high along one axis, returns false if
+    // it never is
+    bool clipAxis(float from, float delta, float low, float high, float &enter, float &leave)
+    {
+        // moving parallel to the slab, inside it all the time or never
+        if (delta == 0.0f)
+            return from >= low && from <= high;
+
+        float lowTime{(low - from) / delta};
+        float highTime{(high - from) / delta};
+
+        if (lowTime > highTime)
+            std::swap(lowTime, highTime);
+
+        enter = std::max(enter, lowTime);
+        leave = std::min(leave, highTime);
+
+        return enter <= leave;
+    }
+}
+
+std::optional<float> Sweep::segmentRectangle(const Vector2 &from, const Vector2 &to, const Rectangle &rectangle)
+{
+    // the times the point is inside both slabs of the
+    // rectangle at once, clipped to this tick
+    float enter{0.0f};
+    float leave{1.0f};
+
+    if (!clipAxis(from.x, to.x - from.x, rectangle.x, rectangle.x + rectangle.width, enter, leave))
+        return std::nullopt;
+
+    if (!clipAxis(from.y, to.y - from.y, rectangle.y, rectangle.y + rectangle.height, enter, leave))
+        return std::nullopt;
+
+    return enter;
+}
+
+std::optional<float> Sweep::segmentExpandingCircle(const Vector2 &from, const Vector2 &to,
+                                                   const Vector2 &center, float startRadius, float endRadius)
+{
+    // the point is at from + t * d and the radius is r0 + t * dr,
+    // they touch where |from + t * d - center| = r0 + t * dr:
+    //   (d.d - dr^2) t^2 + 2 (w.d - r0 dr) t + (w.w - r0^2) = 0
+    // with w = from - center
+    const float wx{from.x - center.x};
+    const float wy{from.y - center.y};
+    const float dx{to.x - from.x};
+    const float dy{to.y - from.y};
+    const float dr{endRadius - startRadius};
+
+    const float c{wx * wx + wy * wy - startRadius * startRadius};
+
+    // inside from the start
+    if (c <= 0.0f)
+        return 0.0f;
+
+    const float a{dx * dx + dy * dy - dr * dr};
+    const float b{2.0f * (wx * dx + wy * dy - startRadius * dr)};
+
+    // outside at t = 0, so the first root in [0, 1] is where
+    // it gets in (if a < 0 the other root is negative)
+    float first{};
+
+    if (a == 0.0f)
+    {
+        // the point and the rim close in at a constant rate
+        if (b >= 0.0f)
+            return std::nullopt;
+
+        first = -c / b;
+    }
+    else
+    {
+        const float discriminant{b * b - 4.0f * a * c};
+
+        if (discriminant < 0.0f)
+            return std::nullopt;
+
+        // the roots without cancelling b against the root
+        const float q{-0.5f * (b + std::copysign(std::sqrt(discriminant), b))};
+        float root0{q / a};
+        float root1{q != 0.0f ? c / q : root0};
+
+        if (root0 > root1)
+            std::swap(root0, root1);
+
+        first = root0 >= 0.0f ? root0 : root1;
+    }
+
+    if (first < 0.0f || first > 1.0f)
+        return std::nullopt;
+
+    return first;
+}
@@ -0,0 +1,228 @@
+#include "WaveDirector.h"
+#include <cmath>     // for std::llround
+#include <algorithm> // for std::max, std::min
+#include <utility>   // for std::exchange, std::move
+
+namespace
+{
+    // the world's own streams start at 0, keep well clear of them
+    constexpr std::uint64_t waveStream{0x7761766573};
+
+    // pending launches a director has room for from the start
+    constexpr std::size_t initialEvents{256};
+
+    // longer than this (centuries at any sane tick rate) is
+    // clamped, so rounding can't overflow and a burst of the
+    // most launches a scenario may have stays far from 2^64 ticks
+    constexpr float maxTicks{1e12f};
+
+    bool isSkyClear(const World &world)
+    {
+        return world.getMissiles(Faction::enemy).empty() && world.getMissiles(Faction::player).empty();
+    }
+}
+
+WaveScript::WaveScript(std::coroutine_handle<promise_type> handle)
+    : m_handle{handle}
+{
+}
+
+WaveScript::~WaveScript()
+{
+    if (m_handle)
+        m_handle.destroy();
+}
+
+WaveScript::WaveScript(WaveScript &&other) noexcept
+    : m_handle{std::exchange(other.m_handle, {})}
+{
+}
+
+WaveScript &WaveScript::operator=(WaveScript &&other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_handle)
+            m_handle.destroy();
+
+        m_handle = std::exchange(other.m_handle, {});
+    }
+
+    return *this;
+}
+
+bool WaveScript::isDone() const { return !m_handle || m_handle.done(); }
+
+WaveDirector::WaveDirector(float tickRate, std::uint64_t seed)
+    : m_tickRate{tickRate},
+      m_rng{seed, waveStream},
+      m_timers{initialEvents}
+{
+}
+
+void WaveDirector::start(WaveScript script)
+{
+    m_starting.push_back(script.m_handle);
+    m_scripts.push_back(std::move(script));
+}
+
+std::uint32_t WaveDirector::update(const World &world)
+{
+    m_world = &world;
+    m_launches = 0;
+
+    // every launch and every script that is due on this tick
+    m_timers.advance([this](const Event &event)
+                     {
+                         m_launches += event.launches;
+
+                         if (event.script)
+                             m_due.push_back(event.script); });
+
+    // the scripts started since the last tick run up to
+    // their first co_await, then the ones due on this tick
+    // pick up where they left off
+    for (std::coroutine_handle<> script : m_starting)
+        resume(script);
+
+    m_starting.clear();
+
+    for (std::coroutine_handle<> script : m_due)
+        resume(script);
+
+    m_due.clear();
+
+    // the conditions last, so they see everything launched
+    // on this tick. a condition met carries its script on
+    // right away, anything that script waits on next is
+    // only looked at from the next tick on
+    m_checking.swap(m_conditions);
+
+    for (const Condition &condition : m_checking)
+    {
+        if (condition.check(condition.awaiter, world))
+            resume(condition.script);
+        else
+            m_conditions.push_back(condition);
+    }
+
+    m_checking.clear();
+
+    m_world = nullptr;
+
+    return m_launches;
+}
+
+bool WaveDirector::isDone() const
+{
+    for (const WaveScript &script : m_scripts)
+    {
+        if (!script.isDone())
+            return false;
+    }
+
+    return true;
+}
+
+std::uint64_t WaveDirector::getTick() const { return m_timers.getNow(); }
+
+std::uint64_t WaveDirector::toTicks(float seconds) const
+{
+    const float ticks{seconds * m_tickRate};
+
+    // negative (or NaN) is no time at all
+    if (!(ticks > 0.0f))
+        return 0;
+
+    return static_cast<std::uint64_t>(std::llround(std::min(ticks, maxTicks)));
+}
+
+Random::Pcg32 &WaveDirector::getRng() { return m_rng; }
+
+const World &WaveDirector::getWorld() const { return *m_world; }
+
+void WaveDirector::launch(std::uint32_t count) { m_launches += count; }
+
+WaveDirector::Delay WaveDirector::wait(std::uint64_t ticks) { return Delay{*this, ticks}; }
+WaveDirector::Delay WaveDirector::waitSeconds(float seconds) { return Delay{*this, toTicks(seconds)}; }
+
+WaveDirector::Burst WaveDirector::burst(std::uint32_t count, std::uint64_t spacing, std::uint32_t perLaunch)
+{
+    return Burst{*this, count, spacing, std::max(1u, perLaunch)};
+}
+
+void WaveDirector::schedule(std::uint64_t ticks, const Event &event)
+{
+    m_timers.schedule(m_timers.getNow() + ticks, event);
+}
+
+bool WaveDirector::scheduleBurst(const Burst &burst, std::coroutine_handle<> script)
+{
+    // the first launch goes out on this tick
+    const std::uint32_t first{std::min(burst.count, burst.perLaunch)};
+    std::uint32_t left{burst.count - first};
+
+    launch(first);
+
+    if (burst.spacing == 0)
+    {
+        launch(left);
+        return false;
+    }
+
+    if (left == 0)
+        return false;
+
+    m_timers.reserve((left + burst.perLaunch - 1) / burst.perLaunch);
+
+    for (std::uint64_t ticks{burst.spacing}; left > 0; ticks += burst.spacing)
+    {
+        const std::uint32_t launches{std::min(left, burst.perLaunch)};
+        left -= launches;
+
+        // the script rides along with the last launch
+        schedule(ticks, Event{left == 0 ? script : std::coroutine_handle<>{}, launches});
+    }
+
+    return true;
+}
+
+void WaveDirector::resume(std::coroutine_handle<> script)
+{
+    if (!script.done())
+        script.resume();
+}
+
+WaveScript campaignWaves(WaveDirector &director)
+{
+    // a moment to look at the city first
+    co_await director.waitSeconds(3.0f);
+
+    for (std::uint32_t wave{0};; ++wave)
+    {
+        // longer and faster every wave, with the odd
+        // pair of missiles at once later on
+        const std::uint32_t count{6 + 3 * wave + director.getRng().nextBounded(3)};
+        const float spacingSeconds{std::max(0.25f, 1.5f - 0.15f * static_cast<float>(wave))};
+        const std::uint32_t perLaunch{wave >= 4 && director.getRng().nextBounded(2) ? 2u : 1u};
+
+        co_await director.burst(count, std::max<std::uint64_t>(1, director.toTicks(spacingSeconds)), perLaunch);
+
+        // the next wave waits for the sky to clear
+        co_await director.until(isSkyClear);
+
+        co_await director.waitSeconds(2.0f);
+    }
+}
+
+WaveScript scenarioWaves(WaveDirector &director, std::span<const ScenarioFormat::Wave> waves)
+{
+    for (const ScenarioFormat::Wave &wave : waves)
+    {
+        co_await director.waitSeconds(wave.delaySeconds);
+        co_await director.burst(wave.count, director.toTicks(wave.spacingSeconds), wave.perLaunch);
+
+        if (wave.flags & ScenarioFormat::waitForClearSky)
+            co_await director.until(isSkyClear);
+    }
+}
@@ -0,0 +1,1247 @@
+#include "World.h"
+#include "Profiler.h"
+#include "Sweep.h"
+#include "Scenario.h"
+#include <raylib.h>
+#include <raymath.h>
+#include <cstddef>      // for std::size_t
+#include <cmath>        // for std::lround, std::ceil
+#include <algorithm>    // for std::max, std::min, std::sort, std::nth_element, std::ranges::equal, std::ranges::any_of
+#include <atomic>       // for std::atomic
+#include <span>         // for std::span
+#include <bit>          // for std::bit_cast
+#include <limits>       // for std::numeric_limits
+#include <cassert>      // for assert
+
+namespace
+{
+    // the tick rate every number of WorldTuning was tuned at
+    constexpr float referenceTickRate{60.0f};
+
+    // the random stream of the enemy spawner
+    // other subsystems get streams of their own,
+    // so adding one never changes the enemies of a seed
+    constexpr std::uint64_t enemyStream{1};
+
+    // coverage cells per collision grid cell (along one side)
+    // small enough for the smallest explosions to cover some
+    constexpr float coverageCellsPerGridCell{8.0f};
+
+    // how far inside its rim a coverage cell has to be, so
+    // rounding can't mark a cell the exact test would miss
+    constexpr float coverageMargin{0.05f};
+}
+
+World::World(const WorldConfig &config)
+    : m_config{config},
+      m_width{config.width},
+      m_height{config.height},
+      m_tickRate{config.tickRate},
+      m_timeScale{referenceTickRate / config.tickRate},
+      m_spawnInterval{config.tuning.spawnIntervalSeconds > 0.0f ? std::max(1, static_cast<int>(std::lround(config.tuning.spawnIntervalSeconds * config.tickRate))) : 0},
+      m_rng{config.seed, enemyStream},
+      m_playerMissiles{config.maxMissiles, config.tuning.missileTopSpeed * m_timeScale},
+      m_enemyMissiles{config.maxMissiles, config.tuning.missileTopSpeed * m_timeScale},
+      m_buildings{config.maxBuildings},
+      m_explosions{config.maxExplosions},
+      m_commands{config.maxMissiles, config.maxExplosions},
+      m_skyline{config.width, config.height, config.skylineColumnWidth, config.maxBuildings},
+      m_explosionGrid{config.width, config.height, config.collisionCellSize},
+      m_explosionCoverage{config.width, config.height, config.collisionCellSize / coverageCellsPerGridCell},
+      m_interceptors{config.autoDefense.enabled ? config.maxMissiles : 0}
+{
+    const ScenarioView scenario{config.scenario, config.width, config.height};
+    assert((config.scenario.empty() || scenario.isValid()) && "the scenario has to be checked before");
+
+    // setup all the buildings based on their
+    // pre-defined constants and store it
+    // in the building pool, unless the scenario
+    // brings a city of its own
+    if (scenario.getBuildings().empty())
+    {
+        setupBigBuildings();
+        setupSmallBuildings();
+    }
+    else
+        setupScenarioBuildings(scenario.getBuildings());
+
+    m_launchSites = scenario.getLaunchSites();
+
+    m_destroyedBuildings.reserve(config.maxBuildings);
+
+    m_enemyHits.resize(config.maxMissiles);
+    m_hitBuildings.resize(config.maxMissiles);
+    m_playerHits.resize(config.maxMissiles);
+    m_expiredExplosions.resize(config.maxExplosions);
+
+    // every explosion at its biggest (it can overshoot the max by
+    // one tick of growth) in as many cells as its square can touch
+    const float biggestExplosion{(config.tuning.maxExplosionRadius + m_timeScale) * 2.0f};
+    const auto cellsPerSide{static_cast<std::size_t>(biggestExplosion / config.collisionCellSize) + 2};
+
+    m_explosionGrid.reserve(config.maxExplosions * cellsPerSide * cellsPerSide);
+
+    if (config.autoDefense.enabled)
+    {
+        const auto batteries{static_cast<std::size_t>(std::max(1, config.autoDefense.batteries))};
+
+        // evenly along the ground between the player's
+        // launcher and its mirror image on the right
+        const Vector2 launcher{getLauncherPosition()};
+        const float spacing{batteries > 1 ? (m_width - 2.0f * launcher.x) / static_cast<float>(batteries - 1) : 0.0f};
+
+        for (std::size_t battery{0}; battery < batteries; ++battery)
+            m_batteries.push_back(Vector2{launcher.x + spacing * static_cast<float>(battery), launcher.y});
+
+        m_reloadTicks = static_cast<std::uint64_t>(std::max(1l, std::lround(config.autoDefense.reloadSeconds * config.tickRate)));
+
+        m_batteryReadyTicks.resize(batteries);
+        m_engagements.resize(config.maxMissiles);
+
+        m_threats.reserve(config.maxMissiles);
+        m_readyBatteries.reserve(batteries);
+        m_pendingEngagements.reserve(batteries);
+        m_intercepts.reserve(config.maxMissiles * batteries);
+    }
+}
+
+void World::step(const InputFrame &input)
+{
+    PROFILE_SCOPE("tick");
+
+    // if there aren't any buildings to collide
+    // there is nothing left to simulate
+    if (isOver())
+        return;
+
+    // work out where every missile is on this tick
+    updateMissiles();
+
+    // missiles that reached their target on this tick
+    detonateMissiles();
+
+    applyCollisions();
+
+    applyInput(input);
+
+    autoDefend();
+
+    spawnEnemies();
+
+    // UPDATE ALL EXPLOSIONS
+    updateExplosions();
+
+    // every phase has seen every entity
+    // now apply what they decided in one go
+    applyCommands();
+
+    ++m_tick;
+}
+
+void World::applyInput(const InputFrame &input)
+{
+    PROFILE_SCOPE("input");
+
+    // detect if user had clicked on the screen
+    if (input.fire)
+    {
+        // if so, create a new player missile
+        Missile playerMissile{};
+
+        setupPlayerMissile(playerMissile, getLauncherPosition(), input.target);
+
+        // add the newly created missile
+        // to the missile store at the end of the tick
+        m_commands.spawnMissile(playerMissile);
+    }
+
+    if (input.enemies > 0)
+        spawnEnemyMissiles(input.enemies);
+}
+
+void World::spawnEnemies()
+{
+    PROFILE_SCOPE("spawn");
+
+    if (m_spawnInterval == 0)
+        return;
+
+    // after certain seconds generate
+    // enemy's missile
+    if (++m_spawnCounter >= m_spawnInterval)
+    {
+        Missile enemyMissile{};
+
+        setupEnemyMissile(enemyMissile);
+
+        // add the newly created missile
+        // to the missile store at the end of the tick
+        m_commands.spawnMissile(enemyMissile);
+
+        // rest the frame counter
+        m_spawnCounter = 0;
+    }
+}
+
+void World::spawnEnemyMissiles(std::uint32_t count)
+{
+    // anything past the store's capacity would be
+    // dropped anyway, don't reserve room for it
+    const auto spawns{static_cast<std::uint32_t>(std::min<std::size_t>(count, m_config.maxMissiles))};
+
+    m_commands.reserveMissileSpawns(spawns);
+
+    for (std::uint32_t spawn{0}; spawn < spawns; ++spawn)
+    {
+        Missile enemyMissile{};
+
+        setupEnemyMissile(enemyMissile);
+        m_commands.spawnMissile(enemyMissile);
+    }
+}
+
+void World::setJobSystem(JobSystem *jobs) { m_jobs = jobs; }
+
+bool World::isOver() const { return m_buildings.empty(); }
+
+std::uint64_t World::getTick() const { return m_tick; }
+
+double World::getRenderTick(float alpha) const
+{
+    // the last step() worked out positions for tick m_tick - 1
+    // and the one before it for m_tick - 2. the first two steps
+    // have nothing before them, those draw tick 0 for the part
+    // that would be before it
+    const double tick{static_cast<double>(m_tick) - 2.0 + static_cast<double>(alpha)};
+
+    return (0.0 > tick) ? 0.0 : tick;
+}
+
+float World::getRenderRadius(const Explosion &explosion, float alpha)
+{
+    // the radius changed by grow on the last tick
+    return explosion.getRadius() - explosion.getGrow() * (1.0f - alpha);
+}
+
+void World::fillSnapshot(RenderSnapshot &snapshot) const
+{
+    snapshot.missiles.clear();
+    snapshot.explosions.clear();
+    snapshot.buildings.clear();
+
+    // room for every entity the world can hold, only
+    // the first snapshot filled in allocates
+    snapshot.missiles.reserve(m_playerMissiles.getCapacity() + m_enemyMissiles.getCapacity());
+    snapshot.explosions.reserve(m_explosions.getCapacity());
+    snapshot.buildings.reserve(m_buildings.getCapacity());
+
+    // the same two ticks getRenderTick() blends between
+    const double previousTick{getRenderTick(0.0f)};
+
+    for (const Faction faction : {Faction::player, Faction::enemy})
+    {
+        const MissileStore &missiles{getMissiles(faction)};
+
+        for (std::size_t missile{0}; missile < missiles.size(); ++missile)
+        {
+            snapshot.missiles.push_back({missiles.getStartPos(missile),
+                                         missiles.getEndPos(missile, previousTick),
+                                         missiles.getEndPos(missile),
+                                         faction});
+        }
+    }
+
+    for (const Explosion &explosion : m_explosions)
+    {
+        snapshot.explosions.push_back({explosion.getPosition(),
+                                       getRenderRadius(explosion, 0.0f),
+                                       explosion.getRadius(),
+                                       explosion.getTint()});
+    }
+
+    for (const Rectangle2D &building : m_buildings)
+        snapshot.buildings.push_back({building.getRectangle(), building.getTint()});
+
+    snapshot.tick = m_tick;
+    snapshot.isOver = isOver();
+    snapshot.buildingsVersion = m_buildingsVersion;
+}
+
+float World::getTickRate() const { return m_tickRate; }
+
+const MissileStore &World::getMissiles(Faction faction) const
+{
+    return faction == Faction::player ? m_playerMissiles : m_enemyMissiles;
+}
+
+MissileStore &World::getMissiles(Faction faction)
+{
+    return faction == Faction::player ? m_playerMissiles : m_enemyMissiles;
+}
+
+const Pool<Rectangle2D> &World::getBuildings() const { return m_buildings; }
+const Pool<Explosion> &World::getExplosions() const { return m_explosions; }
+const Skyline &World::getSkyline() const { return m_skyline; }
+
+float World::getWidth() const { return m_width; }
+float World::getHeight() const { return m_height; }
+
+const WorldStats &World::getStats() const { return m_stats; }
+
+WorldMemory World::getMemory() const
+{
+    return WorldMemory{
+        m_playerMissiles.getReservedBytes(),
+        m_enemyMissiles.getReservedBytes(),
+        m_explosions.getReservedBytes(),
+        m_buildings.getReservedBytes(),
+    };
+}
+
+Vector2 World::getLauncherPosition() const
+{
+    // a fixed position from where the player
+    // shoots their missiles
+    return Vector2{
+        50.0f,
+        m_height - 50.0f,
+    };
+}
+
+std::uint64_t World::getPlayerFlightTicks(const Vector2 &target) const
+{
+    return getPlayerFlightTicks(getLauncherPosition(), target);
+}
+
+std::uint64_t World::getPlayerFlightTicks(const Vector2 &launcher, const Vector2 &target) const
+{
+    // the speed setupPlayerMissile() gives the missile
+    return MissileStore::getArrivalAge(Vector2Distance(launcher, target),
+                                       m_config.tuning.playerMissileSpeed * m_timeScale * m_timeScale,
+                                       m_playerMissiles.getTopSpeed());
+}
+
+const std::vector<Vector2> &World::getBatteries() const { return m_batteries; }
+
+namespace
+{
+    // "MCWS", a saved world state
+    constexpr std::uint32_t stateMagic{0x5357434d};
+
+    // bump whenever anything saved by saveState() changes
+    constexpr std::uint8_t stateVersion{7};
+
+    // every field that decides the size of
+    // a container has to match to restore
+    bool isSameShape(const WorldConfig &a, const WorldConfig &b)
+    {
+        return a.width == b.width && a.height == b.height &&
+               a.tickRate == b.tickRate &&
+               a.collisionCellSize == b.collisionCellSize &&
+               a.skylineColumnWidth == b.skylineColumnWidth &&
+               a.maxMissiles == b.maxMissiles &&
+               a.maxExplosions == b.maxExplosions &&
+               a.maxBuildings == b.maxBuildings &&
+               a.autoDefense.enabled == b.autoDefense.enabled &&
+               a.autoDefense.batteries == b.autoDefense.batteries &&
+               std::ranges::equal(a.scenario, b.scenario);
+    }
+}
+
+void World::saveState(std::vector<std::uint8_t> &bytes) const
+{
+    PROFILE_SCOPE("saveState");
+
+    bytes.clear();
+    ByteWriter writer{bytes};
+
+    writer.writeU32(stateMagic);
+    writer.writeU8(stateVersion);
+    writeConfig(writer, m_config);
+
+    writer.writeValue(m_tick);
+    writer.writeValue(m_spawnCounter);
+    writer.writeValue(m_rng);
+    writer.writeValue(m_stats);
+
+    m_playerMissiles.saveState(writer);
+    m_enemyMissiles.saveState(writer);
+    m_buildings.saveState(writer);
+    m_explosions.saveState(writer);
+    m_skyline.saveState(writer);
+
+    writer.writeArray(std::span{m_batteryReadyTicks});
+    writer.writeArray(std::span{m_engagements});
+}
+
+bool World::restoreState(std::span<const std::uint8_t> bytes)
+{
+    PROFILE_SCOPE("restoreState");
+
+    const std::optional<WorldConfig> config{readStateConfig(bytes)};
+
+    if (!config || !isSameShape(*config, m_config))
+        return false;
+
+    ByteReader reader{bytes};
+
+    // skip the header checked by readStateConfig()
+    reader.readU32();
+    reader.readU8();
+    readConfig(reader);
+
+    m_config.seed = config->seed;
+
+    m_tick = reader.readValue<std::uint64_t>();
+    m_spawnCounter = reader.readValue<int>();
+    m_rng = reader.readValue<Random::Pcg32>();
+    m_stats = reader.readValue<WorldStats>();
+
+    const bool playerMissilesRestored{m_playerMissiles.restoreState(reader)};
+    const bool enemyMissilesRestored{m_enemyMissiles.restoreState(reader)};
+    const bool buildingsRestored{m_buildings.restoreState(reader)};
+    const bool explosionsRestored{m_explosions.restoreState(reader)};
+    const bool skylineRestored{m_skyline.restoreState(reader)};
+
+    // whatever was standing before, it isn't now
+    ++m_buildingsVersion;
+
+    reader.readArray(m_batteryReadyTicks, m_batteries.size());
+    reader.readArray(m_engagements, m_config.autoDefense.enabled ? m_config.maxMissiles : 0);
+
+    // nothing recorded before the restore belongs to this state
+    m_commands.clear();
+    m_pendingEngagements.clear();
+
+    return playerMissilesRestored && enemyMissilesRestored && buildingsRestored && explosionsRestored && skylineRestored &&
+           !reader.hasFailed() && reader.isAtEnd();
+}
+
+std::optional<WorldConfig> World::readStateConfig(std::span<const std::uint8_t> bytes)
+{
+    ByteReader reader{bytes};
+
+    if (reader.readU32() != stateMagic || reader.readU8() != stateVersion)
+        return std::nullopt;
+
+    const WorldConfig config{readConfig(reader)};
+
+    // a world can't be built on a scenario that doesn't load
+    if (reader.hasFailed() || (!config.scenario.empty() && !ScenarioView{config.scenario, config.width, config.height}.isValid()))
+        return std::nullopt;
+
+    return config;
+}
+
+void World::writeConfig(ByteWriter &writer, const WorldConfig &config)
+{
+    writer.writeFloat(config.width);
+    writer.writeFloat(config.height);
+    writer.writeVarint(config.seed);
+    writer.writeFloat(config.tickRate);
+    writer.writeFloat(config.collisionCellSize);
+    writer.writeFloat(config.skylineColumnWidth);
+    writer.writeVarint(config.maxMissiles);
+    writer.writeVarint(config.maxExplosions);
+    writer.writeVarint(config.maxBuildings);
+
+    const WorldTuning &tuning{config.tuning};
+    writer.writeFloat(tuning.enemyMissileSpeed);
+    writer.writeFloat(tuning.playerMissileSpeed);
+    writer.writeFloat(tuning.missileTopSpeed);
+    writer.writeFloat(tuning.spawnIntervalSeconds);
+    writer.writeFloat(tuning.minExplosionRadius);
+    writer.writeFloat(tuning.maxExplosionRadius);
+    writer.writeVarint(static_cast<std::uint64_t>(tuning.bigBuildings));
+    writer.writeVarint(static_cast<std::uint64_t>(tuning.smallBuildings));
+    writer.writeFloat(tuning.bigBuildingSize);
+    writer.writeFloat(tuning.smallBuildingSize);
+
+    const AutoDefenseConfig &autoDefense{config.autoDefense};
+    writer.writeU8(autoDefense.enabled);
+    writer.writeVarint(static_cast<std::uint64_t>(autoDefense.batteries));
+    writer.writeFloat(autoDefense.reloadSeconds);
+    writer.writeVarint(static_cast<std::uint64_t>(autoDefense.solveBudget));
+
+    // the scenario goes in as it is, aligned, so whoever reads
+    // it back can use it in place out of the bytes it read
+    writer.writeVarint(config.scenario.size());
+
+    if (!config.scenario.empty())
+    {
+        writer.writePadding(ScenarioFormat::alignment);
+        writer.writeBytes(config.scenario);
+    }
+}
+
+WorldConfig World::readConfig(ByteReader &reader)
+{
+    WorldConfig config{};
+    config.width = reader.readFloat();
+    config.height = reader.readFloat();
+    config.seed = reader.readVarint();
+    config.tickRate = reader.readFloat();
+    config.collisionCellSize = reader.readFloat();
+    config.skylineColumnWidth = reader.readFloat();
+    config.maxMissiles = reader.readVarint();
+    config.maxExplosions = reader.readVarint();
+    config.maxBuildings = reader.readVarint();
+
+    WorldTuning &tuning{config.tuning};
+    tuning.enemyMissileSpeed = reader.readFloat();
+    tuning.playerMissileSpeed = reader.readFloat();
+    tuning.missileTopSpeed = reader.readFloat();
+    tuning.spawnIntervalSeconds = reader.readFloat();
+    tuning.minExplosionRadius = reader.readFloat();
+    tuning.maxExplosionRadius = reader.readFloat();
+    tuning.bigBuildings = static_cast<int>(reader.readVarint());
+    tuning.smallBuildings = static_cast<int>(reader.readVarint());
+    tuning.bigBuildingSize = reader.readFloat();
+    tuning.smallBuildingSize = reader.readFloat();
+
+    AutoDefenseConfig &autoDefense{config.autoDefense};
+    autoDefense.enabled = reader.readU8() != 0;
+    autoDefense.batteries = static_cast<int>(reader.readVarint());
+    autoDefense.reloadSeconds = reader.readFloat();
+    autoDefense.solveBudget = static_cast<int>(reader.readVarint());
+
+    // a view into the reader's bytes, nothing is copied
+    const std::uint64_t scenarioSize{reader.readVarint()};
+
+    if (scenarioSize > 0)
+    {
+        // more than there is left fails the reader
+        reader.skipPadding(ScenarioFormat::alignment);
+        config.scenario = reader.readBytes(static_cast<std::size_t>(scenarioSize));
+    }
+
+    return config;
+}
+
+const WorldConfig &World::getConfig() const { return m_config; }
+
+std::uint64_t World::getStateHash() const
+{
+    // FNV-1a style, one 64 bit word at a time
+    std::uint64_t hash{14695981039346656037ull};
+
+    const auto mix{[&hash](std::uint64_t value)
+                   {
+                       hash ^= value;
+                       hash *= 1099511628211ull;
+                       hash ^= hash >> 32;
+                   }};
+
+    const auto mixFloat{[&mix](float value)
+                        { mix(std::bit_cast<std::uint32_t>(value)); }};
+
+    const auto mixHandle{[&mix](const Handle &handle)
+                         { mix((static_cast<std::uint64_t>(handle.generation) << 32) | handle.slot); }};
+
+    mix(m_tick);
+    mix(static_cast<std::uint64_t>(m_spawnCounter));
+    mix(m_rng.getState());
+    mix(m_rng.getIncrement());
+
+    for (const Faction faction : {Faction::player, Faction::enemy})
+    {
+        const MissileStore &missiles{getMissiles(faction)};
+
+        mix(missiles.size());
+
+        for (std::size_t missile{0}; missile < missiles.size(); ++missile)
+        {
+            const Vector2 endPos{missiles.getEndPos(missile)};
+
+            mixHandle(missiles.getHandle(missile));
+            mixFloat(endPos.x);
+            mixFloat(endPos.y);
+            mix(missiles.getArrivalTick(missile));
+        }
+    }
+
+    mix(m_explosions.size());
+
+    for (std::size_t explosion{0}; explosion < m_explosions.size(); ++explosion)
+    {
+        mixHandle(m_explosions.getHandle(explosion));
+        mixFloat(m_explosions[explosion].getPosition().x);
+        mixFloat(m_explosions[explosion].getPosition().y);
+        mixFloat(m_explosions[explosion].getRadius());
+        mixFloat(m_explosions[explosion].getGrow());
+    }
+
+    mix(m_buildings.size());
+
+    for (std::size_t building{0}; building < m_buildings.size(); ++building)
+        mixHandle(m_buildings.getHandle(building));
+
+    // only the engagements still running decide anything
+    for (std::uint64_t readyTick : m_batteryReadyTicks)
+        mix(readyTick);
+
+    for (std::size_t missile{0}; missile < m_enemyMissiles.size() && !m_engagements.empty(); ++missile)
+        mix(isEngaged(missile));
+
+    return hash;
+}
+
+std::uint64_t World::getCandidatePairs() const
+{
+    return m_explosionGrid.getCandidatePairs();
+}
+
+void World::updateMissiles()
+{
+    PROFILE_SCOPE("updateMissiles");
+
+    // a missile's position only depends on how long ago
+    // it was launched, so nothing is stepped here, the
+    // positions are just worked out for this tick
+    // (SIMD when available, split across jobs when there are any)
+    parallelFor(m_playerMissiles.size(), JobSystem::getPerCacheLine<float>(),
+                [this](std::size_t first, std::size_t last)
+                { m_playerMissiles.evaluate(m_tick, first, last); });
+
+    parallelFor(m_enemyMissiles.size(), JobSystem::getPerCacheLine<float>(),
+                [this](std::size_t first, std::size_t last)
+                { m_enemyMissiles.evaluate(m_tick, first, last); });
+}
+
+void World::detonateMissiles()
+{
+    PROFILE_SCOPE("detonateMissiles");
+
+    // the tick every missile reaches its target was worked out
+    // when it was launched, so only the missiles due now are
+    // touched instead of checking every missile every tick
+    for (const Handle &handle : m_playerMissiles.collectArrivals(m_tick))
+    {
+        // a player's missile that reaches its target position
+        // adds a new explosion in the pool
+        Explosion explosion{
+            m_playerMissiles.getTargetPos(m_playerMissiles.find(handle)),
+            m_config.tuning.minExplosionRadius,
+        };
+
+        // grow by one unit per 60th of a second
+        explosion.setGrow(m_timeScale);
+
+        m_commands.spawnExplosion(explosion);
+        m_commands.killMissile(Faction::player, handle);
+    }
+
+    // an enemy missile that reaches the ground just goes,
+    // collideEnemyMissiles() still sees it hit a roof on the way
+    for (const Handle &handle : m_enemyMissiles.collectArrivals(m_tick))
+        m_commands.killMissile(Faction::enemy, handle);
+}
+
+void World::autoDefend()
+{
+    PROFILE_SCOPE("autoDefense");
+
+    if (m_batteries.empty())
+        return;
+
+    m_readyBatteries.clear();
+
+    for (std::size_t battery{0}; battery < m_batteries.size(); ++battery)
+    {
+        if (m_batteryReadyTicks[battery] <= m_tick)
+            m_readyBatteries.push_back(battery);
+    }
+
+    if (m_readyBatteries.empty())
+        return;
+
+    // every enemy missile nobody is after yet
+    m_threats.clear();
+
+    for (std::size_t missile{0}; missile < m_enemyMissiles.size(); ++missile)
+    {
+        if (!isEngaged(missile))
+            m_threats.push_back(static_cast<std::uint32_t>(missile));
+    }
+
+    if (m_threats.empty())
+        return;
+
+    // the one landing first is the most urgent, ties go
+    // to the lower index so the order is always the same
+    const auto landsEarlier{[this](std::uint32_t a, std::uint32_t b)
+                            {
+                                const std::uint64_t arrivalA{m_enemyMissiles.getArrivalTick(a)};
+                                const std::uint64_t arrivalB{m_enemyMissiles.getArrivalTick(b)};
+
+                                return arrivalA < arrivalB || (arrivalA == arrivalB && a < b);
+                            }};
+
+    // the budget is spent on the most urgent threats,
+    // the rest wait for a later tick
+    const std::size_t budget{static_cast<std::size_t>(std::max(1, m_config.autoDefense.solveBudget))};
+    const std::size_t maxThreats{std::max<std::size_t>(1, budget / m_readyBatteries.size())};
+
+    if (m_threats.size() > maxThreats)
+    {
+        std::nth_element(m_threats.begin(), m_threats.begin() + static_cast<std::ptrdiff_t>(maxThreats), m_threats.end(), landsEarlier);
+        m_threats.resize(maxThreats);
+    }
+
+    std::sort(m_threats.begin(), m_threats.end(), landsEarlier);
+
+    // every ready battery against every threat, in one batch each
+    const std::size_t threats{m_threats.size()};
+    const float interceptorSpeed{m_config.tuning.playerMissileSpeed * m_timeScale * m_timeScale};
+
+    m_interceptors.gather(m_enemyMissiles, m_threats, m_tick);
+    m_intercepts.resize(m_readyBatteries.size() * threats);
+
+    for (std::size_t ready{0}; ready < m_readyBatteries.size(); ++ready)
+    {
+        m_interceptors.solve(m_batteries[m_readyBatteries[ready]], interceptorSpeed, m_playerMissiles.getTopSpeed(),
+                             std::span<float>{m_intercepts}.subspan(ready * threats, threats));
+    }
+
+    // greedy: the most urgent threat first, taken by
+    // the battery whose interceptor gets there soonest
+    std::size_t batteriesLeft{m_readyBatteries.size()};
+
+    for (std::size_t threat{0}; threat < threats && batteriesLeft > 0; ++threat)
+    {
+        std::size_t best{SlotMap::npos};
+        float bestAhead{std::numeric_limits<float>::infinity()};
+
+        for (std::size_t ready{0}; ready < m_readyBatteries.size(); ++ready)
+        {
+            const float ahead{m_intercepts[ready * threats + threat]};
+
+            if (m_readyBatteries[ready] != SlotMap::npos && ahead >= 0.0f && ahead < bestAhead)
+            {
+                best = ready;
+                bestAhead = ahead;
+            }
+        }
+
+        if (best == SlotMap::npos)
+            continue;
+
+        if (fireBattery(m_readyBatteries[best], m_threats[threat], static_cast<std::uint64_t>(std::ceil(bestAhead))))
+        {
+            m_readyBatteries[best] = SlotMap::npos;
+            --batteriesLeft;
+        }
+    }
+}
+
+bool World::fireBattery(std::size_t battery, std::size_t missile, std::uint64_t ahead)
+{
+    const Vector2 &launcher{m_batteries[battery]};
+    const std::uint64_t arrival{m_enemyMissiles.getArrivalTick(missile)};
+
+    // the solver works in floats and fractions of a tick,
+    // the interceptor in whole ticks. check its real flight
+    // time and wait a tick or two longer if it's short
+    for (; m_tick + ahead + 2 <= arrival; ++ahead)
+    {
+        const Vector2 target{m_enemyMissiles.getEndPos(missile, static_cast<double>(m_tick + ahead + 1))};
+
+        if (getPlayerFlightTicks(launcher, target) > ahead)
+            continue;
+
+        // the missile only counts as engaged once the
+        // interceptor makes it into the store
+        m_pendingEngagements.push_back(PendingEngagement{m_commands.getMissileSpawns().size(),
+                                                         m_enemyMissiles.getHandle(missile),
+                                                         m_tick + ahead + 2});
+
+        Missile interceptor{};
+        setupPlayerMissile(interceptor, launcher, target);
+        m_commands.spawnMissile(interceptor);
+
+        m_batteryReadyTicks[battery] = m_tick + m_reloadTicks;
+
+        return true;
+    }
+
+    return false;
+}
+
+bool World::isEngaged(std::size_t missile) const
+{
+    const Handle handle{m_enemyMissiles.getHandle(missile)};
+    const Engagement &engagement{m_engagements[handle.slot]};
+
+    return engagement.generation == handle.generation && engagement.untilTick > m_tick;
+}
+
+void World::updateExplosions()
+{
+    PROFILE_SCOPE("updateExplosions");
+
+    // every explosion only changes itself, so they
+    // can be updated in any order on any thread...
+    parallelFor(m_explosions.size(), JobSystem::getPerCacheLine<Explosion>(),
+                [this](std::size_t first, std::size_t last)
+                { updateExplosions(first, last); });
+
+    // ...but the kills are recorded here, in pool order,
+    // so the command buffer always sees the same sequence
+    for (std::size_t explosion{0}; explosion < m_explosions.size(); ++explosion)
+    {
+        if (m_expiredExplosions[explosion])
+            m_commands.killExplosion(m_explosions.getHandle(explosion));
+    }
+}
+
+void World::updateExplosions(std::size_t first, std::size_t last)
+{
+    for (std::size_t explosion{first}; explosion < last; ++explosion)
+    {
+        const float minExplosionRadius{m_config.tuning.minExplosionRadius};
+        const float maxExplosionRadius{m_config.tuning.maxExplosionRadius};
+        const float currentExplosionRadius{m_explosions[explosion].getRadius()};
+
+        m_expiredExplosions[explosion] = 0;
+
+        // reduce the explosion size if it's > max explosion radius
+        if (currentExplosionRadius >= maxExplosionRadius)
+            m_explosions[explosion].setGrow(-m_timeScale);
+
+        // a shrunk explosion is removed at the end of the tick
+        if (currentExplosionRadius < minExplosionRadius)
+        {
+            m_expiredExplosions[explosion] = 1;
+            continue;
+        }
+
+        // grow is 1 per 60th of a second
+        m_explosions[explosion].setRadius(currentExplosionRadius + m_explosions[explosion].getGrow());
+    }
+}
+
+void World::setupPlayerMissile(Missile &playerMissile, const Vector2 &launcher, const Vector2 &target) const
+{
+
+    // initialise the new missile
+    // set the position from where the player
+    // (or a battery) shoots it
+    playerMissile.setStartPos(launcher);
+
+    // and set player's missile end position to starting position
+    playerMissile.setEndPos(playerMissile.getStartPos());
+
+    // set player's missile distance
+    // missile's distance is zero by default
+
+    // set the speed of player's missile
+    // speed is added every tick, so it scales twice
+    playerMissile.setMissileSpeed(m_config.tuning.playerMissileSpeed * m_timeScale * m_timeScale);
+
+    // it's the player's (drawn in their colour)
+    playerMissile.setFaction(Faction::player);
+
+    // now, set the clicked position as target position
+    playerMissile.setTargetPos(target);
+}
+
+void World::setupEnemyMissile(Missile &enemyMissile)
+{
+    // every random x is picked from [0, width]
+    const int maxX{static_cast<int>(m_width)};
+
+    // set a random starting position of the missile
+    // all starting position's Y should be zero
+    // unless the scenario has launch sites, then it's
+    // anywhere along one of them
+    if (m_launchSites.empty())
+    {
+        enemyMissile.setStartPos(Vector2{
+            static_cast<float>(m_rng.getInt(0, maxX)),
+            0,
+        });
+    }
+    else
+    {
+        const ScenarioFormat::LaunchSite &site{m_launchSites[m_rng.nextBounded(static_cast<std::uint32_t>(m_launchSites.size()))]};
+
+        enemyMissile.setStartPos(Vector2{m_rng.getFloat(site.minX, site.maxX), site.y});
+    }
+
+    // set the end position of the missile same
+    // as starting position
+    enemyMissile.setEndPos(enemyMissile.getStartPos());
+
+    // set enemy's missile distance
+    // missile's distance is zero by default
+
+    // set the speed of enemy's missile
+    // speed is added every tick, so it scales twice
+    enemyMissile.setMissileSpeed(m_config.tuning.enemyMissileSpeed * m_timeScale * m_timeScale);
+
+    // it's an enemy's
+    enemyMissile.setFaction(Faction::enemy);
+
+    // now, set a random position as target position
+    // all target position's Y should be equivalent to world height
+    enemyMissile.setTargetPos(Vector2{
+        static_cast<float>(m_rng.getInt(0, maxX)),
+        m_height,
+    });
+}
+
+void World::placeBuildings(int noOfBuildings, float buildingW, float buildingH, const Color &color, float width, float innerPadding, float outerPadding)
+{
+    for (float i{0}; i < static_cast<float>(noOfBuildings); ++i)
+    {
+        // set building's width and height respectively
+        Rectangle2D building{buildingW, buildingH};
+
+        // because we want to show the last building inside the width
+        const float newWidth{width - building.getWidth()};
+
+        // calculated gap between each building using new width
+        const float gap{newWidth / static_cast<float>(noOfBuildings)};
+
+        // to keep a symmetry and consistency
+        // innerPadding + outerPadding = (gap / 2)
+
+        building.setPosition(Vector2{
+            (gap + innerPadding) * i + outerPadding,
+            m_height - building.getHeight(),
+        });
+
+        building.setTint(color);
+
+        // raise the skyline where the building stands
+        const Handle handle{m_buildings.spawn(building)};
+
+        if (handle.isValid())
+            m_skyline.addBuilding(handle, building.getRectangle());
+    }
+}
+
+void World::setupBigBuildings()
+{
+    const float bigBuildingW{m_config.tuning.bigBuildingSize};
+    const float bigBuildingH{m_config.tuning.bigBuildingSize};
+    constexpr Color bigBuildingColor{GRAY};
+
+    // constants related to big buildings
+    const int maxBigBuildings{m_config.tuning.bigBuildings};
+    constexpr float innerPadding{100.0f};
+    constexpr float outerPadding{20.0f};
+
+    placeBuildings(maxBigBuildings, bigBuildingW, bigBuildingH,
+                   bigBuildingColor, m_width, innerPadding, outerPadding);
+}
+
+void World::setupSmallBuildings()
+{
+    const float smallBuildingW{m_config.tuning.smallBuildingSize};
+    const float smallBuildingH{m_config.tuning.smallBuildingSize};
+    constexpr Color smallBuildingColor{LIGHTGRAY};
+
+    // constants related to small buildings
+    const int maxSmallBuildings{m_config.tuning.smallBuildings};
+    constexpr float innerPadding{0.0f};
+    constexpr float outerPadding{145.0f};
+    constexpr float bigBuildingGap{240.0f};
+
+    // place one set of small buildings on left side
+    placeBuildings(maxSmallBuildings,
+                   smallBuildingW, smallBuildingH,
+                   smallBuildingColor, bigBuildingGap,
+                   innerPadding, outerPadding);
+
+    // place one set of small buildings on right side
+    placeBuildings(maxSmallBuildings,
+                   smallBuildingW, smallBuildingH,
+                   smallBuildingColor, bigBuildingGap,
+                   innerPadding,
+
+                   // move this set of buildings to right side
+                   // this below multiplication is based on trial-and-error
+                   outerPadding * 3.35f);
+}
+
+void World::setupScenarioBuildings(std::span<const ScenarioFormat::Building> buildings)
+{
+    for (const ScenarioFormat::Building &scenarioBuilding : buildings)
+    {
+        Rectangle2D building{scenarioBuilding.width, scenarioBuilding.height};
+
+        // right on the ground, whatever y + height rounded to
+        building.setPosition(Vector2{scenarioBuilding.x, m_height - scenarioBuilding.height});
+        building.setTint(Color{scenarioBuilding.tint[0], scenarioBuilding.tint[1], scenarioBuilding.tint[2], scenarioBuilding.tint[3]});
+
+        // raise the skyline where the building stands
+        const Handle handle{m_buildings.spawn(building)};
+
+        if (handle.isValid())
+            m_skyline.addBuilding(handle, building.getRectangle());
+    }
+}
+
+void World::applyCollisions()
+{
+    PROFILE_SCOPE("applyCollisions");
+
+    m_explosionGrid.resetCandidatePairs();
+
+    // return if there are no missiles
+    if (m_playerMissiles.empty() && m_enemyMissiles.empty())
+        return;
+
+    // explosions grow and shrink every tick
+    // so their grid is rebuilt every tick
+    rebuildExplosionGrid();
+
+    // nothing is erased or recorded while the missiles
+    // are tested, each one only writes down what it hit,
+    // so the tests can run on any number of threads.
+    // every faction is tested only against what it can hit
+    std::atomic<std::uint64_t> candidatePairs{0};
+
+    parallelFor(m_enemyMissiles.size(), JobSystem::getPerCacheLine<MissileHit>(),
+                [this, &candidatePairs](std::size_t first, std::size_t last)
+                { candidatePairs.fetch_add(collideEnemyMissiles(first, last), std::memory_order_relaxed); });
+
+    parallelFor(m_playerMissiles.size(), JobSystem::getPerCacheLine<MissileHit>(),
+                [this, &candidatePairs](std::size_t first, std::size_t last)
+                { candidatePairs.fetch_add(collidePlayerMissiles(first, last), std::memory_order_relaxed); });
+
+    m_explosionGrid.addCandidatePairs(candidatePairs.load(std::memory_order_relaxed));
+
+    // the hits are turned into kills in missile order,
+    // the same order a single thread would record them in
+    for (std::size_t missile{0}; missile < m_enemyMissiles.size(); ++missile)
+    {
+        switch (m_enemyHits[missile])
+        {
+        case MissileHit::building:
+            // both the missile and the collided building go
+            m_commands.killMissile(Faction::enemy, m_enemyMissiles.getHandle(missile));
+            m_commands.killBuilding(m_hitBuildings[missile]);
+            break;
+
+        case MissileHit::explosion:
+            m_commands.killMissile(Faction::enemy, m_enemyMissiles.getHandle(missile));
+            ++m_stats.enemyMissilesIntercepted;
+            break;
+
+        case MissileHit::none:
+            break;
+        }
+    }
+
+    for (std::size_t missile{0}; missile < m_playerMissiles.size(); ++missile)
+    {
+        if (m_playerHits[missile] == MissileHit::explosion)
+            m_commands.killMissile(Faction::player, m_playerMissiles.getHandle(missile));
+    }
+}
+
+std::uint64_t World::collideEnemyMissiles(std::size_t first, std::size_t last)
+{
+    std::uint64_t candidatePairs{0};
+
+    // the previous tick, where every missile came from
+    // (a missile launched on it is still where it started)
+    const std::uint64_t previousTick{m_tick - 1};
+
+    for (std::size_t missile{first}; missile < last; ++missile)
+    {
+        m_enemyHits[missile] = MissileHit::none;
+
+        // everything the missile passed since the last tick is
+        // tested, not just where it is now, so a fast missile
+        // can't skip over a building or an explosion
+        const Vector2 from{m_enemyMissiles.getEndPosOnTick(missile, previousTick)};
+        const Vector2 to{m_enemyMissiles.getEndPos(missile)};
+
+        // how far along that way it hit something, the
+        // building wins if it's hit at the same time
+        float impact{2.0f};
+
+        // sweep the skyline along the missile's way
+        const Handle building{m_skyline.sweep(from, to, impact)};
+
+        if (building.isValid())
+        {
+            m_enemyHits[missile] = MissileHit::building;
+            m_hitBuildings[missile] = building;
+        }
+
+        // missiles that arrived on this tick are handled by
+        // detonateMissiles(), but one may still have gone
+        // through a roof on its way down to the ground
+        if (m_enemyMissiles.getArrivalTick(missile) <= m_tick)
+            continue;
+
+        if (sweepExplosions(from, to, impact, candidatePairs))
+            m_enemyHits[missile] = MissileHit::explosion;
+    }
+
+    return candidatePairs;
+}
+
+std::uint64_t World::collidePlayerMissiles(std::size_t first, std::size_t last)
+{
+    std::uint64_t candidatePairs{0};
+    const std::uint64_t previousTick{m_tick - 1};
+
+    for (std::size_t missile{first}; missile < last; ++missile)
+    {
+        m_playerHits[missile] = MissileHit::none;
+
+        // missiles that arrived on this tick explode in
+        // detonateMissiles(), there's nothing left to hit
+        if (m_playerMissiles.getArrivalTick(missile) <= m_tick)
+            continue;
+
+        const Vector2 from{m_playerMissiles.getEndPosOnTick(missile, previousTick)};
+        const Vector2 to{m_playerMissiles.getEndPos(missile)};
+
+        if (sweepExplosions(from, to, 2.0f, candidatePairs))
+            m_playerHits[missile] = MissileHit::explosion;
+    }
+
+    return candidatePairs;
+}
+
+bool World::sweepExplosions(const Vector2 &from, const Vector2 &to, float impact, std::uint64_t &candidatePairs) const
+{
+    // a missile that didn't hit anything else and ends up in a
+    // cell some explosion covers whole was caught by it, no
+    // matter when. only the others need the exact test
+    if (impact > 1.0f && m_explosionCoverage.isCovered(to))
+        return true;
+
+    bool isHit{false};
+
+    // check collision with the explosions in
+    // the cells along the missile's way
+    const auto sweep{[&](std::span<const std::uint32_t> candidates)
+                     {
+                         for (std::uint32_t explosion : candidates)
+                         {
+                             const Explosion &candidate{m_explosions[explosion]};
+
+                             // the explosion grew (or shrank) during
+                             // the tick just like the missile moved
+                             const std::optional<float> hit{Sweep::segmentExpandingCircle(
+                                 from, to, candidate.getPosition(), getRenderRadius(candidate, 0.0f), candidate.getRadius())};
+
+                             if (hit && *hit < impact)
+                             {
+                                 impact = *hit;
+                                 isHit = true;
+                             }
+                         }
+                     }};
+
+    candidatePairs += m_explosionGrid.findAlong(from, to, sweep);
+
+    return isHit;
+}
+
+void World::applyCommands()
+{
+    PROFILE_SCOPE("applyCommands");
+
+    // kills first, each pool is compacted in a single sweep
+    m_playerMissiles.erase(m_commands.getMissileKills(Faction::player));
+    m_enemyMissiles.erase(m_commands.getMissileKills(Faction::enemy));
+    m_explosions.despawn(m_commands.getExplosionKills());
+
+    // remember where the destroyed buildings stood...
+    // several missiles can hit the same building on one tick,
+    // it's still only one building and it's only removed once
+    m_destroyedBuildings.clear();
+
+    for (const Handle &building : m_commands.getBuildingKills())
+    {
+        const Rectangle2D *rectangle{m_buildings.get(building)};
+
+        if (!rectangle || std::ranges::any_of(m_destroyedBuildings, [&building](const DestroyedBuilding &destroyed)
+                                              { return destroyed.handle == building; }))
+            continue;
+
+        m_destroyedBuildings.push_back(DestroyedBuilding{building, rectangle->getRectangle()});
+    }
+
+    m_buildings.despawn(m_commands.getBuildingKills());
+    m_stats.buildingsLost += m_destroyedBuildings.size();
+
+    if (!m_destroyedBuildings.empty())
+        ++m_buildingsVersion;
+
+    // ...then flatten the skyline under them, so only
+    // buildings that are still standing get stamped back in
+    for (const DestroyedBuilding &destroyed : m_destroyedBuildings)
+        m_skyline.removeBuilding(destroyed.handle, destroyed.rectangle);
+
+    // then spawns, appended behind the survivors. a missile
+    // only counts as fired or spawned if its store took it
+    const std::span<const Missile> missileSpawns{m_commands.getMissileSpawns()};
+    std::size_t pending{0};
+
+    for (std::size_t spawn{0}; spawn < missileSpawns.size(); ++spawn)
+    {
+        const Missile &missile{missileSpawns[spawn]};
+        const bool isPushed{getMissiles(missile.getFaction()).push(missile, m_tick).isValid()};
+
+        if (isPushed)
+        {
+            if (missile.getFaction() == Faction::player)
+                ++m_stats.playerMissilesFired;
+            else
+                ++m_stats.enemyMissilesSpawned;
+        }
+
+        if (pending < m_pendingEngagements.size() && m_pendingEngagements[pending].spawn == spawn)
+        {
+            const Handle &target{m_pendingEngagements[pending].target};
+
+            if (isPushed)
+                m_engagements[target.slot] = Engagement{target.generation, m_pendingEngagements[pending].untilTick};
+
+            ++pending;
+        }
+    }
+
+    m_pendingEngagements.clear();
+
+    for (const Explosion &explosion : m_commands.getExplosionSpawns())
+        m_explosions.spawn(explosion);
+
+    m_commands.clear();
+}
+
+void World::rebuildExplosionGrid()
+{
+    m_explosionGrid.clear();
+    m_explosionCoverage.clear();
+
+    for (std::size_t explosion{0}; explosion < m_explosions.size(); ++explosion)
+    {
+        // an explosion covers the square around its circle
+        // as big as it got during the last tick
+        const Vector2 &position{m_explosions[explosion].getPosition()};
+        const float radius{std::max(m_explosions[explosion].getRadius(), getRenderRadius(m_explosions[explosion], 0.0f))};
+
+        m_explosionGrid.insert(static_cast<std::uint32_t>(explosion),
+                               Rectangle{
+                                   position.x - radius,
+                                   position.y - radius,
+                                   radius * 2.0f,
+                                   radius * 2.0f,
+                               });
+
+        // where the explosion is at the end of the tick
+        m_explosionCoverage.fillCircle(position, m_explosions[explosion].getRadius() - coverageMargin);
+    }
+
+    m_explosionGrid.build();
+}
@@ -1,490 +1,553 @@
-#include "Rectangle2D.h"
-#include "Explosion.h"
-#include "Missile.h"
+#include "World.h"
+#include "InputFrame.h"
+#include "SimulationThread.h"
+#include "RenderSnapshot.h"
 #include "Random.h"
+#include "Profiler.h"
+#include "ReplayRecorder.h"
+#include "ReplayReader.h"
+#include "MappedFile.h"
+#include "JobSystem.h"
+#include "DrawList.h"
+#include "CityLayer.h"
+#include "RlglDrawBackend.h"
+#include "WaveDirector.h"
+#include "Scenario.h"
+#include "AllocationTracker.h"
 #include <raylib.h>
 #include <raymath.h>
-#include <forward_list> // for std::forward_list()
-#include <optional>     // for std::optional
-#include <cassert>      // for assert
-
-void updateMissiles(std::forward_list<Missile> &missiles);
-void updateExplosions(std::forward_list<Explosion> &explosions);
-
-void setupPlayerMissile(Missile &playerMissile);
-void setupEnemyMissile(Missile &enemyMissile);
-
-void setupBigBuildings(std::forward_list<Rectangle2D> &buildings);
-void setupSmallBuildings(std::forward_list<Rectangle2D> &buildings);
+#include <string_view> // for std::string_view
+#include <string>      // for std::string
+#include <charconv>    // for std::from_chars
+#include <vector>      // for std::vector
+#include <memory>      // for std::unique_ptr
+#include <optional>    // for std::optional
+#include <chrono>      // for std::chrono::steady_clock
+#include <iostream>    // for std::cout, std::cerr
+#include <cmath>       // for std::isfinite
+#include <cstdint>     // for std::uint32_t, std::uint64_t
+#include <utility>     // for std::swap
+#include <algorithm>   // for std::max
+
+#if defined(MISSILE_COMMANDER_TRACK_ALLOCATIONS)
+// allocations of every phase since the last refresh and
+// the most it ever held, then what every entity holds,
+// in the top right corner
+static void drawAllocationOverlay(const std::vector<AllocationTracker::PhaseStats> &stats,
+                                  const std::vector<AllocationTracker::PhaseStats> &previous,
+                                  const WorldMemory &memory, int screenW)
+{
+    constexpr int fontSize{10};
+    constexpr int lineHeight{12};
+    const int x{screenW - 280};
+    int y{4};
 
-void placeBuildings(std::forward_list<Rectangle2D> &buildings, int noOfBuildings, float buildingW, float buildingH, const Color &color, float width, float innerPadding, float outerPadding);
+    DrawText(TextFormat("missiles %zu+%zu KiB  explosions %zu KiB  buildings %zu KiB",
+                        memory.playerMissiles / 1024, memory.enemyMissiles / 1024,
+                        memory.explosions / 1024, memory.buildings / 1024),
+             x - 60, y, fontSize, DARKGRAY);
 
-std::optional<float> getTallestBuilding(const std::forward_list<Rectangle2D> &buildings);
+    for (std::size_t phase{0}; phase < stats.size(); ++phase)
+    {
+        const std::uint64_t before{phase < previous.size() ? previous[phase].allocations : 0};
 
-void applyCollisions(std::forward_list<Missile> &missiles, std::forward_list<Rectangle2D> &buildings, std::forward_list<Explosion> &explosions, float buildingCollisionThreshold);
+        y += lineHeight;
+        DrawText(TextFormat("%-18s new %5llu  peak %8llu B", stats[phase].name,
+                            static_cast<unsigned long long>(stats[phase].allocations - before),
+                            static_cast<unsigned long long>(stats[phase].peakBytes)),
+                 x, y, fontSize, stats[phase].allocations != before ? MAROON : DARKGRAY);
+    }
+}
+#endif
 
-int main()
+#if defined(MISSILE_COMMANDER_PROFILE)
+// p50/p99 of every phase and the entity counts
+// in the top left corner, below the fps
+static void drawProfilerOverlay(const std::vector<Profiler::PhaseStats> &stats, const RenderSnapshot &snapshot)
 {
-    constexpr int screenW{800};
-    constexpr int screenH{450};
-
-    InitWindow(screenW, screenH, "Missile Commander");
+    constexpr int fontSize{10};
+    constexpr int lineHeight{12};
+    int y{24};
 
-    SetTargetFPS(60);
+    DrawText(TextFormat("missiles %zu  explosions %zu  buildings %zu",
+                        snapshot.missiles.size(), snapshot.explosions.size(), snapshot.buildings.size()),
+             4, y, fontSize, DARKGRAY);
 
-    /*
-    I'm wondering that I can extend Line2D
-    and add a property like missile distance.
-    And it will keep my codebase modular
-    and in future I can easily use Line2D class
-    as it is. However, it might add a little bit
-    of complexcity in my code.
-    */
+    for (const Profiler::PhaseStats &phase : stats)
+    {
+        y += lineHeight;
+        DrawText(TextFormat("%-18s p50 %7.3f ms  p99 %7.3f ms", phase.name, phase.p50Ms, phase.p99Ms),
+                 4, y, fontSize, DARKGRAY);
+    }
+}
+#endif
+
+// step the world of a replay as fast as possible, without a window,
+// checking every recorded hash on the way
+// with drawStats every tick is also recorded into a draw list
+// and submitted to a backend that only counts the draw calls,
+// and the buildings are kept up to date in a city layer
+// returns the exit code of the program
+// the whole word has to be the number
+template <typename T>
+static bool parseNumber(std::string_view word, T &value)
+{
+    const auto [end, error]{std::from_chars(word.data(), word.data() + word.size(), value)};
+    return error == std::errc{} && end == word.data() + word.size();
+}
 
-    // a list that will store all the shot missiles
-    // it's a singly-linked list so iteration
-    // will only happen from the front of the list.
-    std::forward_list<Missile> missiles{};
+static int playReplay(const std::string &path, JobSystem *jobs, bool drawStats)
+{
+    const MappedFile file{path};
 
-    // a list that will store all the buildings
-    // it's a singly-linked list so iteration
-    // will only happen from the front of the list.
-    std::forward_list<Rectangle2D> buildings{};
+    if (!file.isOpen())
+    {
+        std::cerr << "can't open replay " << path << '\n';
+        return 1;
+    }
 
-    // setup all the buildings based on their
-    // pre-defined constants and store it
-    // in the building list
-    setupBigBuildings(buildings);
+    ReplayReader replay{file.getBytes()};
 
-    // this object is a class type (std::optional)
-    // so make sure before it's non-null
-    // before using it
-    // also make sure that you call getTallestBuilding()
-    // on a non-empty list
-    const std::optional<float> tallestBuilding{getTallestBuilding(buildings)};
+    if (!replay.isValid())
+    {
+        std::cerr << path << " isn't a replay of this version\n";
+        return 1;
+    }
 
-    assert(tallestBuilding && "Something went wrong here!");
+    World world{replay.getConfig()};
+    world.setJobSystem(jobs);
 
-    // this will help us when to start detecting
-    // for collision with all buildings
-    const float buildingCollisionThreshold{screenH - *tallestBuilding};
+    std::uint64_t hashesChecked{0};
+    const auto start{std::chrono::steady_clock::now()};
 
-    setupSmallBuildings(buildings);
+    RenderSnapshot snapshot{};
+    DrawList drawList{};
+    NullDrawBackend drawCounter{};
 
-    // this list will store all the
-    // explosions caused by player's missiles
-    std::forward_list<Explosion> explosions{};
+    const WorldConfig &config{replay.getConfig()};
+    CityLayer cityLayer{static_cast<int>(config.width), static_cast<int>(config.height), RAYWHITE};
+    std::uint64_t cityUpdates{0};
 
-    while (!WindowShouldClose())
+    for (ReplayTick tick{}; replay.readTick(tick);)
     {
+        world.step(tick.input);
 
-        // if there aren't any buildings to collide
-        // simply terminate the game loop
-        if (buildings.empty())
-            break;
-        else
-            applyCollisions(missiles, buildings, explosions, buildingCollisionThreshold);
-
-        // detect if user had clicked on the screen
-        if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+        if (drawStats)
         {
-            // if so, create a new player missile
-            Missile playerMissile{};
+            world.fillSnapshot(snapshot);
 
-            setupPlayerMissile(playerMissile);
+            drawList.clear();
+            drawList.addSnapshot(snapshot, 1.0f);
+            drawList.submit(drawCounter);
 
-            // add the newly created missile
-            // at the front of the list
-            missiles.push_front(playerMissile);
+            cityUpdates += cityLayer.update(snapshot.buildings, snapshot.buildingsVersion);
+            cityLayer.clearDirty();
         }
 
-        static int s_frameCounter{};
-
-        // assuming FPS is set to 60 then
-        // 60 frames: one second
-        // 120 frames: two second
-        // ...
-        constexpr int secondsInFrames{120};
+        if (!tick.hasHash)
+            continue;
 
-        // after certain seconds generate
-        // enemy's missile
-        if (++s_frameCounter == secondsInFrames)
+        if (static_cast<std::uint32_t>(world.getStateHash()) != tick.hash)
         {
-            Missile enemyMissile{};
-
-            setupEnemyMissile(enemyMissile);
-
-            // add the newly created missile
-            // at the front of the list
-            missiles.push_front(enemyMissile);
-
-            // rest the frame counter
-            s_frameCounter = 0;
+            std::cerr << "state hash mismatch after tick " << replay.getTick() - 1 << '\n';
+            return 1;
         }
 
-        // UPDATE ALL MISSILES
-        updateMissiles(missiles);
-
-        // UPDATE ALL EXPLOSIONS
-        updateExplosions(explosions);
-
-        BeginDrawing();
+        ++hashesChecked;
+    }
 
-        ClearBackground(RAYWHITE);
+    if (replay.hasFailed())
+    {
+        std::cerr << path << " is broken after tick " << replay.getTick() << '\n';
+        return 1;
+    }
 
-        // DRAW ALL MISSILES
-        for (const Missile &missile : missiles)
-        {
-            DrawLineV(missile.getStartPos(), missile.getEndPos(), missile.getTint());
-            DrawCircleV(missile.getEndPos(), 5.0f, RED);
-        }
+    const double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
 
-        // DRAW ALL BUILDINGS
-        for (const Rectangle2D &building : buildings)
-            DrawRectangleRec(building.getRectangle(), building.getTint());
+    std::cout << replay.getTick() << " ticks, " << hashesChecked << " hashes match, "
+              << seconds << " s (" << static_cast<double>(replay.getTick()) / seconds << " ticks/s)\n";
 
-        // Draw ALL EXPLOSIONS
-        for (const Explosion &explosion : explosions)
-            DrawCircleV(explosion.getPosition(), explosion.getRadius(), explosion.getTint());
+    if (drawStats && replay.getTick() > 0)
+    {
+        const auto frames{static_cast<double>(replay.getTick())};
 
-        DrawFPS(0, 0);
+        std::cout << "per frame: " << static_cast<double>(drawCounter.getCommands()) / frames << " shapes ("
+                  << static_cast<double>(drawCounter.getCommands(DrawPrimitive::line)) / frames << " lines, "
+                  << static_cast<double>(drawCounter.getCommands(DrawPrimitive::circle)) / frames << " circles, "
+                  << static_cast<double>(drawCounter.getCommands(DrawPrimitive::rectangle)) / frames << " rectangles) in "
+                  << static_cast<double>(drawCounter.getBatches()) / frames << " batches\n";
 
-        EndDrawing();
+        std::cout << "city layer: " << cityUpdates << " updates, "
+                  << cityLayer.getRasterizedPixels() << " pixels rasterized ("
+                  << static_cast<double>(cityLayer.getRasterizedPixels()) / frames << " per frame)\n";
     }
 
-    CloseWindow();
-
     return 0;
 }
 
-void updateMissiles(std::forward_list<Missile> &missiles)
+int main(int argc, char *argv[])
 {
+    constexpr int screenW{800};
+    constexpr int screenH{450};
 
-    // return back to caller if missiles list is empty
-    if (missiles.empty())
-        return;
-
-    for (Missile &missile : missiles)
+    // the simulation and the drawing run at their own rates
+    // --tick-rate sets ticks per second of the simulation
+    // --fps caps the frames drawn per second, 0 means uncapped
+    float tickRate{60.0f};
+    int renderRate{0};
+
+    // --trace writes the profiler samples still in
+    // its ring as a chrome trace when the game ends
+    // (profiling builds only)
+    std::string tracePath{};
+
+    // --record writes the game into a replay file
+    // --replay plays one back without a window and exits
+    // --seed picks the game instead of a random one
+    // --jobs steps on n worker threads (0 = one per spare core)
+    // --auto-defense lets n batteries shoot down missiles on their own
+    // --draw-stats counts the draw calls of every tick of a --replay
+    // --waves sends the enemies in scripted waves instead of one by one
+    // --scenario plays a compiled scenario (tools/scenario) instead
+    // of the built-in city, with its waves if it has any
+    std::string recordPath{};
+    std::string replayPath{};
+    std::string scenarioPath{};
+    std::optional<std::uint64_t> seed{};
+    std::optional<unsigned> jobCount{};
+    int autoDefenseBatteries{0};
+
+    // one every few pixels of ground is already silly
+    constexpr int maxBatteries{64};
+    bool drawStats{false};
+    bool waves{false};
+
+    for (int arg{1}; arg < argc; ++arg)
     {
-        // now, shoot a new missile towards its target position
-        // based on certain distance
-        // after every frame, increment the end position of missile
-        missile.setEndPos(Vector2MoveTowards(missile.getEndPos(), missile.getTargetPos(), missile.getMissileDistance()));
-
-        // increase missile's distance by its respective speed
-        missile.updateMissileDistance(missile.getMissileSpeed());
+        const std::string_view name{argv[arg]};
 
-        // these numbers are set using trial-and-error
-        constexpr float minDistance{0.0f};
-        constexpr float maxDistance{100.0f};
+        // the options without a value
+        if (name == "--draw-stats")
+        {
+            drawStats = true;
+            continue;
+        }
 
-        // clamp missile's distance
-        // so that the value does'nt overflow
-        missile.setMissileDistance(Clamp(missile.getMissileDistance(), minDistance, maxDistance));
-    }
-}
+        if (name == "--waves")
+        {
+            waves = true;
+            continue;
+        }
 
-void updateExplosions(std::forward_list<Explosion> &explosions)
-{
-    // return back to caller if explosion list is empty
-    if (explosions.empty())
-        return;
+        if (arg + 1 >= argc)
+        {
+            std::cerr << name << " wants a value\n";
+            return 2;
+        }
 
-    auto previousExplosion{explosions.before_begin()};
+        const std::string_view value{argv[++arg]};
 
-    for (auto explosion{explosions.begin()}; explosion != explosions.cend(); ++explosion)
-    {
-        constexpr float minExplosionRadius{5.0f};
-        constexpr float maxExplosionRadius{20.0f};
-        const float currentExplosionRadius{explosion->getRadius()};
+        if (name == "--tick-rate")
+        {
+            if (!parseNumber(value, tickRate) || !std::isfinite(tickRate) || tickRate <= 0.0f)
+            {
+                std::cerr << "--tick-rate wants a number of ticks per second above 0, not \"" << value << "\"\n";
+                return 2;
+            }
+        }
+        else if (name == "--fps")
+        {
+            if (!parseNumber(value, renderRate) || renderRate < 0)
+            {
+                std::cerr << "--fps wants a whole number of frames per second, 0 for uncapped, not \"" << value << "\"\n";
+                return 2;
+            }
+        }
+        else if (name == "--trace")
+            tracePath = value;
+        else if (name == "--record")
+            recordPath = value;
+        else if (name == "--replay")
+            replayPath = value;
+        else if (name == "--seed")
+        {
+            std::uint64_t parsed{};
 
-        // reduce the explosion size if it's > max explosion radius
-        if (currentExplosionRadius >= maxExplosionRadius)
-            explosion->setGrow(-1);
+            if (!parseNumber(value, parsed))
+            {
+                std::cerr << "--seed wants a whole number from 0 to 18446744073709551615, not \"" << value << "\"\n";
+                return 2;
+            }
 
-        if (currentExplosionRadius < minExplosionRadius)
+            seed = parsed;
+        }
+        else if (name == "--jobs")
         {
-            explosion = explosions.erase_after(previousExplosion);
+            unsigned parsed{};
 
-            // return back to caller once we reached the
-            // end of the list
-            if (explosion == explosions.cend())
-                return;
-        }
+            if (!parseNumber(value, parsed) || parsed > JobSystem::maxWorkerCount)
+            {
+                std::cerr << "--jobs wants a number of workers from 0 (one per spare core) to " << JobSystem::maxWorkerCount
+                          << ", not \"" << value << "\"\n";
+                return 2;
+            }
 
-        // grow is 1 by default
-        explosion->setRadius(currentExplosionRadius + explosion->getGrow());
+            jobCount = parsed;
+        }
+        else if (name == "--auto-defense")
+        {
+            if (!parseNumber(value, autoDefenseBatteries) || autoDefenseBatteries <= 0 || autoDefenseBatteries > maxBatteries)
+            {
+                std::cerr << "--auto-defense wants a number of batteries from 1 to " << maxBatteries << ", not \"" << value << "\"\n";
+                return 2;
+            }
+        }
+        else if (name == "--scenario")
+            scenarioPath = value;
+        else
+        {
+            std::cerr << "unknown option " << name << '\n';
+            return 2;
+        }
     }
-}
 
-void setupPlayerMissile(Missile &playerMissile)
-{
+    std::unique_ptr<JobSystem> jobs{};
 
-    // initialise the new missile
-    // set a fixed position from where the player
-    // will shoot their missiles
-    playerMissile.setStartPos(Vector2{
-        50.0f,
-        static_cast<float>(GetScreenHeight()) - 50.0f,
-    });
+    if (jobCount)
+        jobs = std::make_unique<JobSystem>(*jobCount);
 
-    // and set player's missile end position to starting position
-    playerMissile.setEndPos(playerMissile.getStartPos());
+    if (!replayPath.empty())
+        return playReplay(replayPath, jobs.get(), drawStats);
 
-    // set player's missile distance
-    // missile's distance is zero by default
+    // the scenario is used in place, the mapping
+    // stays open for as long as the game runs
+    std::unique_ptr<MappedFile> scenarioFile{};
+    ScenarioView scenario{};
 
-    // these numbers are set using trial-and-error
-    constexpr float playerMissileSpeed{1.0f};
+    if (!scenarioPath.empty())
+    {
+        scenarioFile = std::make_unique<MappedFile>(scenarioPath);
 
-    // set the speed of player's missile
-    playerMissile.setMissileSpeed(playerMissileSpeed);
+        if (!scenarioFile->isOpen())
+        {
+            std::cerr << "can't open scenario " << scenarioPath << '\n';
+            return 1;
+        }
 
-    // set missile's color
-    playerMissile.setTint(GREEN);
+        scenario = ScenarioView{scenarioFile->getBytes(), static_cast<float>(screenW), static_cast<float>(screenH)};
 
-    // now, set the clicked position as target position
-    playerMissile.setTargetPos(GetMousePosition());
-}
+        if (!scenario.isValid())
+        {
+            std::cerr << scenarioPath << " isn't a scenario of this version or doesn't fit the screen\n";
+            return 1;
+        }
 
-void setupEnemyMissile(Missile &enemyMissile)
-{
-    // set a random starting position of the missile
-    // all starting position's Y should be zero
-    enemyMissile.setStartPos(Vector2{
-        static_cast<float>(Random::get(0, GetScreenWidth())),
-        0,
-    });
-
-    // set the end position of the missile same
-    // as starting position
-    enemyMissile.setEndPos(enemyMissile.getStartPos());
-
-    // set enemy's missile distance
-    // missile's distance is zero by default
-
-    // these numbers are set using trial-and-error
-    constexpr float enemyMissileSpeed{0.01f};
-
-    // set the speed of enemy's missile
-    enemyMissile.setMissileSpeed(enemyMissileSpeed);
-
-    // set missile's color
-    // default value is RED
-
-    // now, set a random position as target position
-    // all target position's Y should be equivalent to screen height
-    enemyMissile.setTargetPos(Vector2{
-        static_cast<float>(Random::get(0, GetScreenWidth())),
-        static_cast<float>(GetScreenHeight()),
-    });
-}
+        // a scenario with waves sends every enemy
+        if (!scenario.getWaves().empty())
+            waves = true;
+    }
 
-void placeBuildings(std::forward_list<Rectangle2D> &buildings, int noOfBuildings, float buildingW, float buildingH, const Color &color, float width, float innerPadding, float outerPadding)
-{
-    for (float i{0}; i < static_cast<float>(noOfBuildings); ++i)
-    {
-        // set building's width and height respectively
-        Rectangle2D building{buildingW, buildingH};
+    InitWindow(screenW, screenH, "Missile Commander");
 
-        // because we want to show the last building inside the width
-        const float newWidth{width - building.getWidth()};
+    SetTargetFPS(renderRate);
 
-        // calculated gap between each building using new width
-        const float gap{newWidth / static_cast<float>(noOfBuildings)};
+    // the whole game lives inside the world
+    // the window only feeds it input and draws it
+    WorldConfig config{};
+    config.width = static_cast<float>(screenW);
+    config.height = static_cast<float>(screenH);
+    config.tickRate = tickRate;
 
-        // to keep a symmetry and consistency
-        // innerPadding + outerPadding = (gap / 2)
+    // every game played in the window is a new one
+    // unless it's asked to be a particular one
+    // (or the scenario is one)
+    if (!seed)
+        seed = scenario.getSeed();
 
-        building.setPosition(Vector2{
-            (gap + innerPadding) * i + outerPadding,
-            static_cast<float>(GetScreenHeight()) - building.getHeight(),
-        });
+    config.seed = seed ? *seed : Random::generateSeed();
 
-        building.setTint(color);
+    if (scenarioFile)
+    {
+        config.scenario = scenarioFile->getBytes();
+        config.maxBuildings = std::max(config.maxBuildings, scenario.getBuildings().size());
+    }
 
-        buildings.push_front(building);
+    if (autoDefenseBatteries > 0)
+    {
+        config.autoDefense.enabled = true;
+        config.autoDefense.batteries = autoDefenseBatteries;
     }
-}
 
-void setupBigBuildings(std::forward_list<Rectangle2D> &buildings)
-{
-    constexpr float bigBuildingW{80.0f};
-    constexpr float bigBuildingH{80.0f};
-    constexpr Color bigBuildingColor{GRAY};
+    // the director sends every enemy, the world none of its own
+    if (waves)
+        config.tuning.spawnIntervalSeconds = 0.0f;
 
-    // constants related to big buildings
-    constexpr float maxBigBuildings{3.0f};
-    constexpr float innerPadding{100.0f};
-    constexpr float outerPadding{20.0f};
+    // never run more than 5 ticks in one go
+    constexpr int maxStepsPerFrame{5};
 
-    placeBuildings(buildings, maxBigBuildings, bigBuildingW, bigBuildingH,
-                   bigBuildingColor, static_cast<float>(GetScreenWidth()), innerPadding, outerPadding);
-}
+    // the world is stepped on its own thread
+    // this one only feeds it input and draws its snapshots
+    SimulationThread simulation{config, maxStepsPerFrame};
+    simulation.setJobSystem(jobs.get());
 
-void setupSmallBuildings(std::forward_list<Rectangle2D> &buildings)
-{
-    constexpr float smallBuildingW{40.0f};
-    constexpr float smallBuildingH{40.0f};
-    constexpr Color smallBuildingColor{LIGHTGRAY};
-
-    // constants related to small buildings
-    constexpr float maxSmallBuildings{3.0f};
-    constexpr float innerPadding{0.0f};
-    constexpr float outerPadding{145.0f};
-    constexpr float bigBuildingGap{240.0f};
-
-    // place one set of small buildings on left side
-    placeBuildings(buildings, maxSmallBuildings,
-                   smallBuildingW, smallBuildingH,
-                   smallBuildingColor, bigBuildingGap,
-                   innerPadding, outerPadding);
-
-    // place one set of small buildings on right side
-    placeBuildings(buildings, maxSmallBuildings,
-                   smallBuildingW, smallBuildingH,
-                   smallBuildingColor, bigBuildingGap,
-                   innerPadding,
-
-                   // move this set of buildings to right side
-                   // this below multiplication is based on trial-and-error
-                   outerPadding * 3.35f);
-}
+    std::unique_ptr<WaveDirector> director{};
 
-std::optional<float> getTallestBuilding(const std::forward_list<Rectangle2D> &buildings)
-{
-    // return null if building list is empty
-    if (buildings.empty())
-        return std::nullopt;
+    if (waves)
+    {
+        director = std::make_unique<WaveDirector>(config.tickRate, config.seed);
+
+        if (scenario.getWaves().empty())
+            director->start(campaignWaves(*director));
+        else
+            director->start(scenarioWaves(*director, scenario.getWaves()));
+        simulation.setWaveDirector(director.get());
+    }
 
-    float tallestBuilding{};
+    std::unique_ptr<ReplayRecorder> recorder{};
 
-    for (const Rectangle2D &building : buildings)
+    if (!recordPath.empty())
     {
-        if (tallestBuilding < building.getHeight())
-            tallestBuilding = building.getHeight();
+        recorder = std::make_unique<ReplayRecorder>(recordPath, config);
+        simulation.setRecorder(recorder.get());
     }
 
-    return tallestBuilding;
-}
+#if defined(MISSILE_COMMANDER_TRACK_ALLOCATIONS)
+    // the entities are reserved up front, this doesn't change
+    const WorldMemory worldMemory{simulation.getWorldMemory()};
+#endif
+
+    simulation.start();
+
+    // every shape of a frame is recorded here, then drawn
+    // in a handful of batches instead of a call per shape
+    DrawList drawList{};
+    RlglDrawBackend drawBackend{};
+
+    // the background and the buildings, drawn on the CPU
+    // and uploaded only where a building was destroyed
+    CityLayer cityLayer{screenW, screenH, RAYWHITE};
+    const Texture2D cityTexture{LoadTextureFromImage(cityLayer.getImage())};
+    std::vector<Color> cityPixels{};
+
+#if defined(MISSILE_COMMANDER_TRACK_ALLOCATIONS)
+    // the allocation counters as of the last two refreshes
+    std::vector<AllocationTracker::PhaseStats> allocationStats{};
+    std::vector<AllocationTracker::PhaseStats> previousAllocationStats{};
+    int framesUntilAllocationStats{0};
+#endif
+
+#if defined(MISSILE_COMMANDER_PROFILE)
+    // the overlay's numbers, recomputed a few times a second
+    // instead of sorting every sample on every frame
+    std::vector<Profiler::Sample> samples{};
+    std::vector<Profiler::PhaseStats> stats{};
+    int framesUntilStats{0};
+#endif
 
-void applyCollisions(std::forward_list<Missile> &missiles, std::forward_list<Rectangle2D> &buildings, std::forward_list<Explosion> &explosions, float buildingCollisionThreshold)
-{
-    // return if the list is empty
-    if (missiles.empty())
-        return;
+    while (!WindowShouldClose())
+    {
+        PROFILE_SCOPE("frame");
 
-    // used to keep track of previous missile
-    // this iterator should always be initialised
-    // with an iterator pointing before the first iterator
-    auto previousMissile{missiles.before_begin()};
+        const RenderSnapshot &snapshot{simulation.acquireSnapshot()};
 
-    for (auto missile{missiles.begin()}; missile != missiles.cend(); ++missile)
-    {
-        // if the missile reaches its target position
-        // remove it from the list
+        // if there aren't any buildings to collide
+        // simply terminate the game loop
+        if (snapshot.isOver)
+            break;
 
-        // Vector2Equals return int
-        // zero means false
-        // non-zero means true
-        if (Vector2Equals(missile->getEndPos(), missile->getTargetPos()))
-        {
+        // detect if user had clicked on the screen
+        // a full queue means 64 clicks are still waiting for
+        // a tick, dropping one more won't be missed
+        if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+            simulation.pushInput(InputFrame{true, GetMousePosition()});
 
-            // if player's missile reaches its target position
-            if (ColorIsEqual(missile->getTint(), GREEN))
-            {
-                // add a new missile in the list
-                explosions.push_front(Explosion{
-                    missile->getEndPos(),
-                    5.0f,
-                });
-            }
+        // how far we are between the snapshot's tick and the next one
+        const float alpha{Clamp(static_cast<float>((SimulationThread::getTime() - snapshot.publishedAt) / snapshot.tickSeconds), 0.0f, 1.0f)};
 
-            // erase_after(itr) returns
-            // an iterator pointing to the element following
-            // the one that was erased, or
-            // end() if no such element exists.
-
-            // iterator(s) referring to erased
-            // iterator will be left dangling
-            // so we need to update missile iterator
-            // point to the following iterator of
-            // erased iterator.
-            missile = missiles.erase_after(previousMissile);
-
-            // return back to caller once we reach
-            // the end of the list
-            if (missile == missiles.cend())
-                return;
-        }
-        else if (buildingCollisionThreshold < missile->getEndPos().y)
         {
-            // used to keep track of previous missile
-            // this iterator should always be initialised
-            // with an iterator pointing before the first iterator
-            auto previousBuilding{buildings.before_begin()};
+            PROFILE_SCOPE("updateCity");
 
-            for (auto building{buildings.begin()}; building != buildings.cend(); ++building)
+            if (cityLayer.update(snapshot.buildings, snapshot.buildingsVersion))
             {
-
-                // check if the missile's color is equal to
-                // enemy's missile's color
-                if (ColorIsEqual(missile->getTint(), RED))
+                for (const PixelRect &dirty : cityLayer.getDirtyRects())
                 {
-                    // if so, then check for collision with buildings
-                    if (CheckCollisionPointRec(missile->getEndPos(), building->getRectangle()))
-                    {
-                        // erase_after(itr) returns
-                        // an iterator pointing to the element following
-                        // the one that was erased, or
-                        // end() if no such element exists.
-
-                        // iterator(s) referring to erased
-                        // iterator will be left dangling
-                        // so we need to update missile iterator
-                        // point to the following iterator of
-                        // erased iterator.
-                        missile = missiles.erase_after(previousMissile);
-
-                        // remove the collided building from the list
-                        building = buildings.erase_after(previousBuilding);
-
-                        // return back to caller if any
-                        // of the list reach
-                        // the end of the list
-                        if (missile == missiles.cend() || building == buildings.cend())
-                            return;
-                    }
+                    cityLayer.copyPixels(dirty, cityPixels);
+
+                    if (!cityPixels.empty())
+                        UpdateTextureRec(cityTexture,
+                                         Rectangle{static_cast<float>(dirty.x), static_cast<float>(dirty.y),
+                                                   static_cast<float>(dirty.width), static_cast<float>(dirty.height)},
+                                         cityPixels.data());
                 }
 
-                // update the preceding iterator to point to next iterator
-                // on the list
-                ++previousBuilding;
+                cityLayer.clearDirty();
             }
         }
-        // if explosion list is not empty
-        // check collision with all explosions
-        else if (!explosions.empty())
+
+        BeginDrawing();
+
+        // the whole city in one go, it covers the entire
+        // screen so there's nothing to clear either
+        DrawTexture(cityTexture, 0, 0, WHITE);
+
+        // DRAW ALL MISSILES AND EXPLOSIONS
         {
+            PROFILE_SCOPE("recordDraws");
 
-            // check if the current missile collided
-            // with any explosions
-            for (const Explosion &explosion : explosions)
-            {
-                if (CheckCollisionPointCircle(missile->getEndPos(), explosion.getPosition(), explosion.getRadius()))
-                {
-                    missile = missiles.erase_after(previousMissile);
+            drawList.clear();
+            drawList.addSnapshot(snapshot, alpha);
+        }
 
-                    // return back to caller once we reach
-                    // the end of the list
-                    if (missile == missiles.cend())
-                        return;
-                }
-            }
+        {
+            PROFILE_SCOPE("submitDraws");
+
+            drawList.submit(drawBackend);
         }
 
-        // update the preceding iterator to point to next iterator
-        // on the list
-        ++previousMissile;
+        DrawFPS(0, 0);
+
+#if defined(MISSILE_COMMANDER_PROFILE)
+        if (--framesUntilStats <= 0)
+        {
+            Profiler::collect(samples);
+            Profiler::computeStats(samples, stats);
+            framesUntilStats = 15;
+        }
+
+        drawProfilerOverlay(stats, snapshot);
+#endif
+
+#if defined(MISSILE_COMMANDER_TRACK_ALLOCATIONS)
+        if (--framesUntilAllocationStats <= 0)
+        {
+            std::swap(previousAllocationStats, allocationStats);
+            AllocationTracker::collect(allocationStats);
+            framesUntilAllocationStats = 60;
+        }
+
+        drawAllocationOverlay(allocationStats, previousAllocationStats, worldMemory, screenW);
+#endif
+
+        EndDrawing();
     }
-}
\ No newline at end of file
+
+    simulation.stop();
+
+    UnloadTexture(cityTexture);
+
+    // the recorder has seen every tick now
+    if (recorder)
+        recorder->finish();
+
+#if defined(MISSILE_COMMANDER_PROFILE)
+    if (!tracePath.empty())
+    {
+        Profiler::collect(samples);
+        Profiler::exportChromeTrace(samples, tracePath);
+    }
+#endif
+
+    CloseWindow();
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "World.h"
+#include "InputFrame.h"
+#include "RenderSnapshot.h"
+#include "DrawList.h"
+#include "WaveDirector.h"
+#include "JobSystem.h"
+#include "Random.h"
+#include "AllocationTracker.h"
+#include <raylib.h>
+#include <vector>   // for std::vector
+#include <iostream> // for std::cout, std::cerr
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint64_t
+
+// plays a long seeded game without a window, waves and
+// auto-defense and a click every half second, and counts the
+// heap allocations once it's warmed up. every container is
+// reserved up front or has grown to its size by then, so a
+// tick (and recording its draws) shouldn't allocate at all.
+// only built with MISSILE_COMMANDER_TRACK_ALLOCATIONS, ctest
+// builds one of those of its own if the tree isn't one
+namespace
+{
+    // true if no tick allocated after the warm up
+    bool checkAllocations(std::uint64_t seed, JobSystem *jobs)
+    {
+        constexpr float tickRate{60.0f};
+        constexpr std::uint64_t warmUpTicks{60 * 60};
+        constexpr std::uint64_t checkedTicks{10 * 60 * 60};
+        constexpr std::uint64_t ticksPerClick{30};
+
+        WorldConfig config{};
+        config.seed = seed;
+        config.tickRate = tickRate;
+        config.tuning.spawnIntervalSeconds = 0.0f;
+        config.autoDefense.enabled = true;
+
+        World world{config};
+        world.setJobSystem(jobs);
+
+        WaveDirector director{tickRate, seed};
+        director.start(campaignWaves(director));
+
+        // the clicks get a stream of their own
+        Random::Pcg32 clicks{seed, 0x636c69636b};
+
+        RenderSnapshot snapshot{};
+        DrawList drawList{};
+        NullDrawBackend drawCounter{};
+
+        // room for every phase up front, so
+        // collecting doesn't count itself
+        std::vector<AllocationTracker::PhaseStats> before{};
+        std::vector<AllocationTracker::PhaseStats> after{};
+        before.reserve(64);
+        after.reserve(64);
+
+        std::uint64_t allocations{0};
+
+        for (std::uint64_t tick{0}; tick < warmUpTicks + checkedTicks && !world.isOver(); ++tick)
+        {
+            if (tick == warmUpTicks)
+            {
+                AllocationTracker::collect(before);
+                allocations = AllocationTracker::getAllocations();
+            }
+
+            InputFrame input{};
+            input.enemies = director.update(world);
+
+            if (tick % ticksPerClick == 0)
+            {
+                input.fire = true;
+                input.target = Vector2{clicks.getFloat(0.0f, config.width), clicks.getFloat(0.0f, config.height * 0.8f)};
+            }
+
+            world.step(input);
+
+            world.fillSnapshot(snapshot);
+            drawList.clear();
+            drawList.addSnapshot(snapshot, 1.0f);
+            drawList.submit(drawCounter);
+        }
+
+        if (world.getTick() <= warmUpTicks)
+        {
+            std::cerr << "the game ended after " << world.getTick() << " ticks, before it warmed up\n";
+            return false;
+        }
+
+        allocations = AllocationTracker::getAllocations() - allocations;
+        AllocationTracker::collect(after);
+
+        std::cout << world.getTick() - warmUpTicks << " ticks checked after " << warmUpTicks << " warming up, "
+                  << allocations << " allocations\n";
+
+        for (std::size_t phase{0}; phase < after.size(); ++phase)
+        {
+            const std::uint64_t phaseBefore{phase < before.size() ? before[phase].allocations : 0};
+
+            if (after[phase].allocations != phaseBefore)
+                std::cout << "  " << after[phase].name << ": " << after[phase].allocations - phaseBefore << " allocations\n";
+        }
+
+        return allocations == 0;
+    }
+}
+
+int main()
+{
+    if (!AllocationTracker::isEnabled())
+    {
+        std::cerr << "allocation_test needs a build with -DMISSILE_COMMANDER_TRACK_ALLOCATIONS=ON\n";
+        return 1;
+    }
+
+    // on the calling thread, then spread over workers
+    // (the pool starts its threads before the game does)
+    const bool serial{checkAllocations(1, nullptr)};
+
+    JobSystem jobs{2};
+    const bool parallel{checkAllocations(1, &jobs)};
+
+    return serial && parallel ? 0 : 1;
+}
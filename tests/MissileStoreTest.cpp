@@ -0,0 +1,96 @@
+#include "MissileStore.h"
+#include "Missile.h"
+#include "Random.h"
+#include <raylib.h>
+#include <array>    // for std::array
+#include <iostream> // for std::cout, std::cerr
+#include <bit>      // for std::bit_cast
+#include <cstddef>  // for std::size_t
+#include <cstdint>  // for std::uint32_t, std::uint64_t
+
+// the SIMD evaluate() has to agree with evaluateScalar() bit for
+// bit, a replay recorded on one machine hashes the same on any
+// other only if it does. random missiles launched on random
+// ticks, some of them erased again so every tail length of the
+// vector loop comes up, evaluated on ticks during and after
+// their flights by both paths and by getEndPosOnTick()
+namespace
+{
+    bool isSame(Vector2 a, Vector2 b)
+    {
+        return std::bit_cast<std::uint64_t>(a) == std::bit_cast<std::uint64_t>(b);
+    }
+
+    // the number of missiles that came out different
+    std::size_t checkStore(std::size_t count, std::uint64_t seed)
+    {
+        constexpr float topSpeed{8.0f};
+
+        MissileStore simd{count, topSpeed};
+        MissileStore scalar{count, topSpeed};
+        Random::Pcg32 random{seed};
+
+        for (std::size_t missile{0}; missile < count; ++missile)
+        {
+            Missile launched{};
+            launched.setStartPos(Vector2{random.getFloat(0.0f, 800.0f), random.getFloat(0.0f, 10.0f)});
+            launched.setEndPos(launched.getStartPos());
+            launched.setTargetPos(Vector2{random.getFloat(0.0f, 800.0f), 450.0f});
+            launched.setMissileSpeed(random.getFloat(0.001f, 0.5f));
+
+            const std::uint64_t launchTick{random.nextBounded(200)};
+            simd.push(launched, launchTick);
+            scalar.push(launched, launchTick);
+        }
+
+        // every third one gone, the rest keep their order
+        for (std::size_t index{count}; index-- > 0;)
+        {
+            if (index % 3 == 0)
+            {
+                simd.erase(simd.getHandle(index));
+                scalar.erase(scalar.getHandle(index));
+            }
+        }
+
+        std::size_t mismatches{0};
+
+        for (std::uint64_t tick{200}; tick < 1000; tick += 7)
+        {
+            simd.evaluate(tick);
+            scalar.evaluateScalar(tick);
+
+            for (std::size_t index{0}; index < simd.size(); ++index)
+            {
+                if (!isSame(simd.getEndPos(index), scalar.getEndPos(index)) ||
+                    !isSame(simd.getEndPos(index), simd.getEndPosOnTick(index, tick)))
+                    ++mismatches;
+            }
+        }
+
+        return mismatches;
+    }
+}
+
+int main()
+{
+    // around every vector width, and a big one
+    constexpr std::array<std::size_t, 11> counts{1, 2, 3, 5, 8, 9, 15, 17, 31, 64, 1000};
+
+    std::size_t mismatches{0};
+
+    for (std::size_t count : counts)
+    {
+        for (std::uint64_t seed{1}; seed <= 8; ++seed)
+            mismatches += checkStore(count, seed);
+    }
+
+    if (mismatches > 0)
+    {
+        std::cerr << mismatches << " missiles evaluated differently by the SIMD and scalar paths\n";
+        return 1;
+    }
+
+    std::cout << "evaluate() and evaluateScalar() agree\n";
+    return 0;
+}
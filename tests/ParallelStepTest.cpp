@@ -0,0 +1,95 @@
+#include "World.h"
+#include "InputFrame.h"
+#include "JobSystem.h"
+#include "Random.h"
+#include <raylib.h>
+#include <iostream>  // for std::cout, std::cerr
+#include <algorithm> // for std::max
+#include <cstddef>   // for std::size_t
+#include <cstdint>   // for std::uint64_t
+
+// a world stepped on worker threads has to hash exactly like one
+// stepped on the calling thread, tick for tick, or a replay would
+// depend on the machine it's played on. two worlds get the same
+// crowded game (a rain of enemies, auto-defense and a click every
+// few ticks), one of them with a job system, and their hashes are
+// compared after every tick
+namespace
+{
+    // enough enemies in flight that the parallel
+    // phases really split into several ranges
+    constexpr std::size_t crowded{512};
+
+    // the tick the hashes first differed on, or 0
+    // peakEnemies is the most enemies in flight at once
+    std::uint64_t checkGame(std::uint64_t seed, JobSystem &jobs, std::size_t &peakEnemies)
+    {
+        // the rain flattens the city well before that
+        constexpr std::uint64_t ticks{3000};
+
+        WorldConfig config{};
+        config.seed = seed;
+        config.autoDefense.enabled = true;
+
+        World serial{config};
+        World parallel{config};
+        parallel.setJobSystem(&jobs);
+
+        Random::Pcg32 random{seed, 0x696e707574};
+
+        for (std::uint64_t tick{0}; tick < ticks && !serial.isOver(); ++tick)
+        {
+            InputFrame input{};
+            input.enemies = random.nextBounded(12);
+
+            if (tick % 4 == 0)
+            {
+                input.fire = true;
+                input.target = Vector2{random.getFloat(0.0f, config.width), random.getFloat(0.0f, config.height * 0.8f)};
+            }
+
+            serial.step(input);
+            parallel.step(input);
+
+            if (serial.getStateHash() != parallel.getStateHash() || serial.isOver() != parallel.isOver())
+                return serial.getTick();
+
+            const World &world{serial};
+            peakEnemies = std::max(peakEnemies, world.getMissiles(Faction::enemy).size());
+        }
+
+        return 0;
+    }
+}
+
+int main()
+{
+    JobSystem jobs{3};
+
+    std::size_t peakEnemies{0};
+    int failures{0};
+
+    for (std::uint64_t seed{1}; seed <= 8; ++seed)
+    {
+        const std::uint64_t tick{checkGame(seed, jobs, peakEnemies)};
+
+        if (tick > 0)
+        {
+            std::cerr << "seed " << seed << ": the parallel world hashed differently on tick " << tick << '\n';
+            ++failures;
+        }
+    }
+
+    // a game too quiet to split proves nothing
+    if (peakEnemies < crowded)
+    {
+        std::cerr << "at most " << peakEnemies << " enemies in flight, the parallel phases never split\n";
+        return 1;
+    }
+
+    if (failures > 0)
+        return 1;
+
+std::cout << "serial and parallel steps hash the same, up to " << peakEnemies << " enemies in flight\n";
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "AutoPlayer.h"
+#include <raylib.h>
+#include <cmath>     // for std::lround
+#include <algorithm> // for std::erase_if, std::find, std::max
+#include <limits>    // for std::numeric_limits
+
+namespace
+{
+    // the world's own streams start at 0, keep well clear of them
+    constexpr std::uint64_t playerStream{0x706c61796572};
+}
+
+AutoPlayer::AutoPlayer(const World &world, float fireCooldownSeconds, float aimError, std::uint64_t seed)
+    : m_cooldownTicks{static_cast<std::uint64_t>(std::max(1l, std::lround(fireCooldownSeconds * world.getTickRate())))},
+      m_aimError{aimError},
+      m_rng{seed, playerStream}
+{
+}
+
+InputFrame AutoPlayer::think(const World &world)
+{
+    const MissileStore &missiles{world.getMissiles(Faction::enemy)};
+    const std::uint64_t tick{world.getTick()};
+
+    // forget the missiles that are gone
+    std::erase_if(m_targeted, [&missiles](const Handle &handle)
+                  { return missiles.find(handle) == SlotMap::npos; });
+
+    if (tick < m_nextFireTick)
+        return InputFrame{};
+
+    // the threat that lands first
+    std::size_t threat{SlotMap::npos};
+    std::uint64_t threatArrival{std::numeric_limits<std::uint64_t>::max()};
+
+    for (std::size_t missile{0}; missile < missiles.size(); ++missile)
+    {
+        if (missiles.getArrivalTick(missile) >= threatArrival)
+            continue;
+
+        if (std::find(m_targeted.begin(), m_targeted.end(), missiles.getHandle(missile)) != m_targeted.end())
+            continue;
+
+        threat = missile;
+        threatArrival = missiles.getArrivalTick(missile);
+    }
+
+    if (threat == SlotMap::npos)
+        return InputFrame{};
+
+    InputFrame input{};
+
+    if (findIntercept(world, threat, input.target) == 0)
+        return InputFrame{};
+
+    if (m_aimError > 0.0f)
+    {
+        input.target.x += m_rng.getFloat(-m_aimError, m_aimError);
+        input.target.y += m_rng.getFloat(-m_aimError, m_aimError);
+    }
+
+    input.fire = true;
+    m_targeted.push_back(missiles.getHandle(threat));
+    m_nextFireTick = tick + m_cooldownTicks;
+
+    return input;
+}
+
+std::uint64_t AutoPlayer::findIntercept(const World &world, std::size_t missile, Vector2 &target) const
+{
+    const MissileStore &missiles{world.getMissiles(Faction::enemy)};
+    const std::uint64_t tick{world.getTick()};
+    const std::uint64_t arrival{missiles.getArrivalTick(missile)};
+
+    // a missile fired on this tick is launched at the end
+    // of it, explodes flightTicks later and the explosion
+    // catches missiles from the tick after that on
+    for (std::uint64_t ahead{1}; tick + ahead + 1 < arrival; ++ahead)
+    {
+        const Vector2 position{missiles.getEndPos(missile, static_cast<double>(tick + ahead + 1))};
+
+        if (world.getPlayerFlightTicks(position) <= ahead)
+        {
+            target = position;
+            return ahead;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include "World.h"
+#include "InputFrame.h"
+#include "SlotMap.h"
+#include "Random.h"
+#include <vector>  // for std::vector
+#include <cstdint> // for std::uint64_t
+
+#ifndef AUTO_PLAYER_H
+#define AUTO_PLAYER_H
+
+// a scripted player for headless games
+// it picks the enemy missile that lands first and fires
+// where that missile will be once its own missile gets
+// there. it can fire once per cooldown and misses its aim
+// by up to aimError pixels, which stands in for how fast
+// and how well a human clicks.
+// the misses come from its own generator, so it plays
+// the same game every time for the same seed.
+class AutoPlayer
+{
+public:
+    AutoPlayer(const World &world, float fireCooldownSeconds, float aimError, std::uint64_t seed);
+
+    // what to do on the tick the world is about to step
+    InputFrame think(const World &world);
+
+private:
+    // the first tick (counted from now) on which a player
+    // missile fired now would meet the missile at index,
+    // 0 if it can't catch it before it lands
+    std::uint64_t findIntercept(const World &world, std::size_t missile, Vector2 &target) const;
+
+    std::uint64_t m_cooldownTicks{};
+    std::uint64_t m_nextFireTick{};
+
+    float m_aimError{};
+    Random::Pcg32 m_rng;
+
+    // enemy missiles already fired at
+    std::vector<Handle> m_targeted{};
+};
+
+#endif
@@ -0,0 +1,436 @@
+#include "AutoPlayer.h"
+#include "World.h"
+#include "JobSystem.h"
+#include <array>       // for std::array
+#include <vector>      // for std::vector
+#include <string>      // for std::string
+#include <string_view> // for std::string_view
+#include <fstream>     // for std::ofstream
+#include <iostream>    // for std::cout, std::cerr
+#include <chrono>      // for std::chrono::steady_clock
+#include <charconv>    // for std::from_chars
+#include <cmath>       // for std::lround, std::isfinite
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint64_t
+
+namespace
+{
+    // every WorldTuning number the grid can sweep, by name
+    struct FloatKnob
+    {
+        std::string_view name{};
+        float WorldTuning::*member{};
+    };
+
+    struct IntKnob
+    {
+        std::string_view name{};
+        int WorldTuning::*member{};
+    };
+
+    constexpr std::array floatKnobs{
+        FloatKnob{"enemyMissileSpeed", &WorldTuning::enemyMissileSpeed},
+        FloatKnob{"playerMissileSpeed", &WorldTuning::playerMissileSpeed},
+        FloatKnob{"missileTopSpeed", &WorldTuning::missileTopSpeed},
+        FloatKnob{"spawnIntervalSeconds", &WorldTuning::spawnIntervalSeconds},
+        FloatKnob{"minExplosionRadius", &WorldTuning::minExplosionRadius},
+        FloatKnob{"maxExplosionRadius", &WorldTuning::maxExplosionRadius},
+        FloatKnob{"bigBuildingSize", &WorldTuning::bigBuildingSize},
+        FloatKnob{"smallBuildingSize", &WorldTuning::smallBuildingSize},
+    };
+
+    constexpr std::array intKnobs{
+        IntKnob{"bigBuildings", &WorldTuning::bigBuildings},
+        IntKnob{"smallBuildings", &WorldTuning::smallBuildings},
+    };
+
+    // the player is part of the balance too
+    constexpr std::string_view fireCooldownKnob{"fireCooldownSeconds"};
+    constexpr std::string_view aimErrorKnob{"aimError"};
+
+    // one parameter set: the world's numbers and the player's
+    struct Scenario
+    {
+        WorldTuning tuning{};
+        float fireCooldownSeconds{0.5f};
+
+        // pixels, about what a quick mouse flick misses by
+        float aimError{8.0f};
+
+        // the value of every axis, in axis order, for the csv
+        std::vector<double> values{};
+    };
+
+    // one swept knob and the values it takes
+    struct Axis
+    {
+        std::string name{};
+        std::vector<double> values{};
+    };
+
+    struct Options
+    {
+        std::vector<Axis> axes{};
+
+        // games per parameter set
+        std::size_t games{1000};
+
+        // a game still going after this long counts as survived
+        double maxSeconds{600.0};
+
+        float tickRate{60.0f};
+
+        // game n of every parameter set uses seed + n, so the
+        // sets are compared on the very same enemy waves
+        std::uint64_t seed{1};
+
+        unsigned jobs{0};
+        std::string outPath{};
+    };
+
+    struct GameResult
+    {
+        std::uint64_t ticks{};
+        bool survived{};
+        WorldStats stats{};
+    };
+
+    bool setKnob(Scenario &scenario, std::string_view name, double value)
+    {
+        for (const FloatKnob &knob : floatKnobs)
+        {
+            if (knob.name == name)
+            {
+                scenario.tuning.*knob.member = static_cast<float>(value);
+                return true;
+            }
+        }
+
+        for (const IntKnob &knob : intKnobs)
+        {
+            if (knob.name == name)
+            {
+                scenario.tuning.*knob.member = static_cast<int>(std::lround(value));
+                return true;
+            }
+        }
+
+        if (name == fireCooldownKnob)
+        {
+            scenario.fireCooldownSeconds = static_cast<float>(value);
+            return true;
+        }
+
+        if (name == aimErrorKnob)
+        {
+            scenario.aimError = static_cast<float>(value);
+            return true;
+        }
+
+        return false;
+    }
+
+    // the whole word has to be the number
+    template <typename T>
+    bool parseNumber(std::string_view word, T &value)
+    {
+        const auto [end, error]{std::from_chars(word.data(), word.data() + word.size(), value)};
+        return error == std::errc{} && end == word.data() + word.size();
+    }
+
+    template <typename T>
+    bool parsePositive(std::string_view word, T &value)
+    {
+        return parseNumber(word, value) && std::isfinite(value) && value > 0;
+    }
+
+    // name=v1,v2,...
+    bool parseAxis(std::string_view text, Axis &axis)
+    {
+        const std::size_t equals{text.find('=')};
+
+        if (equals == std::string_view::npos || equals == 0)
+            return false;
+
+        axis.name = text.substr(0, equals);
+        text.remove_prefix(equals + 1);
+
+        while (!text.empty())
+        {
+            const std::size_t comma{text.find(',')};
+            const std::string_view value{text.substr(0, comma)};
+
+            double parsed{};
+
+            if (!parseNumber(value, parsed) || !std::isfinite(parsed))
+                return false;
+
+            axis.values.push_back(parsed);
+
+            if (comma == std::string_view::npos)
+                break;
+
+            text.remove_prefix(comma + 1);
+        }
+
+        return !axis.values.empty();
+    }
+
+    bool parseOptions(int argc, char *argv[], Options &options)
+    {
+        for (int arg{1}; arg < argc; ++arg)
+        {
+            const std::string_view name{argv[arg]};
+
+            // every option takes a value
+            if (arg + 1 == argc)
+            {
+                std::cerr << name << " wants a value\n";
+                return false;
+            }
+
+            const std::string_view value{argv[++arg]};
+
+            bool parsed{};
+            std::string_view wanted{};
+
+            if (name == "--set")
+            {
+                Axis axis{};
+
+                if (!parseAxis(value, axis))
+                {
+                    std::cerr << "--set wants name=value[,value...], got " << value << '\n';
+                    return false;
+                }
+
+                Scenario probe{};
+
+                if (!setKnob(probe, axis.name, 0.0))
+                {
+                    std::cerr << "unknown knob " << axis.name << ", known ones are:";
+
+                    for (const FloatKnob &knob : floatKnobs)
+                        std::cerr << ' ' << knob.name;
+
+                    for (const IntKnob &knob : intKnobs)
+                        std::cerr << ' ' << knob.name;
+
+                    std::cerr << ' ' << fireCooldownKnob << ' ' << aimErrorKnob << '\n';
+                    return false;
+                }
+
+                options.axes.push_back(axis);
+                continue;
+            }
+            else if (name == "--games")
+            {
+                parsed = parseNumber(value, options.games) && options.games > 0;
+                wanted = "a whole number above 0";
+            }
+            else if (name == "--max-seconds")
+            {
+                parsed = parsePositive(value, options.maxSeconds);
+                wanted = "a number of seconds above 0";
+            }
+            else if (name == "--tick-rate")
+            {
+                parsed = parsePositive(value, options.tickRate);
+                wanted = "a number of ticks per second above 0";
+            }
+            else if (name == "--seed")
+            {
+                parsed = parseNumber(value, options.seed);
+                wanted = "a whole number from 0 to 18446744073709551615";
+            }
+            else if (name == "--jobs")
+            {
+                parsed = parseNumber(value, options.jobs) && options.jobs <= JobSystem::maxWorkerCount;
+                wanted = "a number of workers from 0 (one per spare core) to 1024";
+            }
+            else if (name == "--out")
+            {
+                options.outPath = value;
+                parsed = !value.empty();
+                wanted = "a file to write";
+            }
+            else
+            {
+                std::cerr << "unknown option " << name << '\n';
+                return false;
+            }
+
+            if (!parsed)
+            {
+                std::cerr << name << " wants " << wanted << ", not \"" << value << "\"\n";
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // every combination of the axis values, the last axis
+    // changing fastest
+    std::vector<Scenario> expandGrid(const std::vector<Axis> &axes)
+    {
+        std::vector<Scenario> scenarios{Scenario{}};
+
+        for (const Axis &axis : axes)
+        {
+            std::vector<Scenario> expanded{};
+            expanded.reserve(scenarios.size() * axis.values.size());
+
+            for (const Scenario &scenario : scenarios)
+            {
+                for (double value : axis.values)
+                {
+                    Scenario next{scenario};
+                    setKnob(next, axis.name, value);
+                    next.values.push_back(value);
+
+                    expanded.push_back(next);
+                }
+            }
+
+            scenarios = expanded;
+        }
+
+        return scenarios;
+    }
+
+    // one whole game, start to finish, on the calling thread
+    GameResult playGame(const Scenario &scenario, const Options &options, std::uint64_t seed)
+    {
+        WorldConfig config{};
+        config.seed = seed;
+        config.tickRate = options.tickRate;
+        config.tuning = scenario.tuning;
+
+        World world{config};
+        AutoPlayer player{world, scenario.fireCooldownSeconds, scenario.aimError, seed};
+
+        const auto maxTicks{static_cast<std::uint64_t>(options.maxSeconds * static_cast<double>(options.tickRate))};
+
+        while (!world.isOver() && world.getTick() < maxTicks)
+            world.step(player.think(world));
+
+        return GameResult{world.getTick(), !world.isOver(), world.getStats()};
+    }
+
+    void writeCsv(std::ostream &out, const Options &options, const std::vector<Scenario> &scenarios, const std::vector<GameResult> &results)
+    {
+        for (const Axis &axis : options.axes)
+            out << axis.name << ',';
+
+        out << "games,meanSurvivalSeconds,survivalRate,meanBuildingsLost,interceptRate,playerMissilesPerIntercept\n";
+
+        for (std::size_t scenario{0}; scenario < scenarios.size(); ++scenario)
+        {
+            double ticks{0.0};
+            double survived{0.0};
+            double buildingsLost{0.0};
+            double spawned{0.0};
+            double intercepted{0.0};
+            double fired{0.0};
+
+            for (std::size_t game{0}; game < options.games; ++game)
+            {
+                const GameResult &result{results[scenario * options.games + game]};
+
+                ticks += static_cast<double>(result.ticks);
+                survived += result.survived;
+                buildingsLost += static_cast<double>(result.stats.buildingsLost);
+                spawned += static_cast<double>(result.stats.enemyMissilesSpawned);
+                intercepted += static_cast<double>(result.stats.enemyMissilesIntercepted);
+                fired += static_cast<double>(result.stats.playerMissilesFired);
+            }
+
+            const auto games{static_cast<double>(options.games)};
+
+            for (double value : scenarios[scenario].values)
+                out << value << ',';
+
+            out << options.games << ','
+                << ticks / games / static_cast<double>(options.tickRate) << ','
+                << survived / games << ','
+                << buildingsLost / games << ','
+                << (spawned > 0.0 ? intercepted / spawned : 0.0) << ','
+                << (intercepted > 0.0 ? fired / intercepted : 0.0) << '\n';
+        }
+    }
+}
+
+// balance [--set knob=v1,v2,...]... [--games n] [--max-seconds s]
+//         [--tick-rate r] [--seed s] [--jobs n] [--out results.csv]
+// plays --games headless games with a scripted player for every
+// combination of the --set values and writes one csv row per
+// combination to --out (or stdout)
+int main(int argc, char *argv[])
+{
+    Options options{};
+
+    if (!parseOptions(argc, argv, options))
+        return 2;
+
+    // opened before hours of games, not after
+    std::ofstream out{};
+
+    if (!options.outPath.empty())
+    {
+        out.open(options.outPath);
+
+        if (!out)
+        {
+            std::cerr << "can't write " << options.outPath << '\n';
+            return 1;
+        }
+    }
+
+    const std::vector<Scenario> scenarios{expandGrid(options.axes)};
+
+    // one result per game, written by whichever thread played
+    // it and summed up in order, so the csv doesn't depend
+    // on the number of threads
+    std::vector<GameResult> results(scenarios.size() * options.games);
+
+    // --jobs 0 means one worker per spare core
+    JobSystem jobs{options.jobs};
+
+    std::cerr << scenarios.size() << " parameter sets x " << options.games << " games on "
+              << jobs.getThreadCount() << " threads\n";
+
+    const auto start{std::chrono::steady_clock::now()};
+
+    // games take very different times, the small ranges
+    // let idle threads steal the long ones (parallelFor()
+    // would keep a run of 16 games or fewer on one thread)
+    jobs.parallelForHeavy(results.size(),
+                          [&](std::size_t first, std::size_t last)
+                          {
+                              for (std::size_t game{first}; game < last; ++game)
+                                  results[game] = playGame(scenarios[game / options.games], options, options.seed + game % options.games);
+                          });
+
+    const double seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+
+    std::cerr << results.size() << " games in " << seconds << " s, "
+              << static_cast<double>(results.size()) / seconds << " games/s\n";
+
+    if (options.outPath.empty())
+    {
+        writeCsv(std::cout, options, scenarios, results);
+        return 0;
+    }
+
+    writeCsv(out, options, scenarios, results);
+    out.close();
+
+    if (!out)
+    {
+        std::cerr << "couldn't write all of " << options.outPath << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,314 @@
+#include "Scenario.h"
+#include "World.h"
+#include <raylib.h>
+#include <vector>      // for std::vector
+#include <string>      // for std::string, std::getline, std::to_string
+#include <string_view> // for std::string_view
+#include <fstream>     // for std::ifstream, std::ofstream
+#include <iostream>    // for std::cerr
+#include <charconv>    // for std::from_chars
+#include <algorithm>   // for std::min
+#include <cmath>       // for std::isfinite, std::abs
+#include <limits>      // for std::numeric_limits
+#include <cstddef>     // for std::size_t
+#include <cstdint>     // for std::uint8_t, std::uint32_t, std::uint64_t
+
+// compiles a scenario from text into the binary format the game
+// maps and uses in place (see include/ScenarioFormat.h)
+//
+//   scenario_compiler city.txt city.mcs
+//
+// one statement per line, # starts a comment:
+//
+//   seed <n>
+//   building <x> <y> <width> <height> [<r> <g> <b> [<a>]]
+//   launch <minX> <maxX> [<y>]
+//   wave <delaySeconds> <count> <spacingSeconds> [<perLaunch>] [clear]
+//
+// buildings stand on the ground of the game's world, 800 x 450, so
+// y + height has to be 450, and lie between x 0 and 800. they are
+// gray unless they get a colour. enemy missiles start
+// anywhere along one of the launch sites (y is 0 unless given). a
+// wave starts delaySeconds after the previous one and launches count
+// missiles, perLaunch at a time every spacingSeconds; with clear the
+// next wave only starts counting once the sky is clear of missiles.
+// a wave sends at most 65536 missiles and waits at most an hour.
+// without buildings or launch sites the game uses its own.
+namespace
+{
+    // the words of a line, without the comment
+    std::vector<std::string_view> split(std::string_view line)
+    {
+        line = line.substr(0, line.find('#'));
+
+        std::vector<std::string_view> words{};
+        std::size_t position{0};
+
+        while (true)
+        {
+            const std::size_t first{line.find_first_not_of(" \t\r", position)};
+
+            if (first == std::string_view::npos)
+                break;
+
+            const std::size_t last{std::min(line.find_first_of(" \t\r", first), line.size())};
+
+            words.push_back(line.substr(first, last - first));
+            position = last;
+        }
+
+        return words;
+    }
+
+    // the whole word has to be the number
+    template <typename T>
+    bool parseNumber(std::string_view word, T &value)
+    {
+        const auto [end, error]{std::from_chars(word.data(), word.data() + word.size(), value)};
+        return error == std::errc{} && end == word.data() + word.size();
+    }
+
+    bool parseFloat(std::string_view word, float &value)
+    {
+        return parseNumber(word, value) && std::isfinite(value);
+    }
+
+    bool parseColourChannel(std::string_view word, std::uint8_t &value)
+    {
+        std::uint32_t channel{};
+
+        if (!parseNumber(word, channel) || channel > std::numeric_limits<std::uint8_t>::max())
+            return false;
+
+        value = static_cast<std::uint8_t>(channel);
+        return true;
+    }
+
+    // the statements of the source, one line at a time
+    // every error is reported as path:line: what's wrong
+    class Compiler
+    {
+    public:
+        Compiler(const std::string &path, float worldWidth, float worldHeight)
+            : m_path{path},
+              m_worldWidth{worldWidth},
+              m_worldHeight{worldHeight}
+        {
+        }
+
+        bool compileLine(std::string_view line)
+        {
+            ++m_line;
+
+            const std::vector<std::string_view> words{split(line)};
+
+            if (words.empty())
+                return true;
+
+            const std::string_view statement{words[0]};
+
+            if (statement == "seed")
+                return compileSeed(words);
+
+            if (statement == "building")
+                return compileBuilding(words);
+
+            if (statement == "launch")
+                return compileLaunchSite(words);
+
+            if (statement == "wave")
+                return compileWave(words);
+
+            return fail("unknown statement " + std::string{statement});
+        }
+
+        const ScenarioBuilder &getBuilder() const { return m_builder; }
+
+        std::size_t getBuildings() const { return m_buildings; }
+        std::size_t getLaunchSites() const { return m_launchSites; }
+        std::size_t getWaves() const { return m_waves; }
+
+    private:
+        bool fail(const std::string &message) const
+        {
+            std::cerr << m_path << ':' << m_line << ": " << message << '\n';
+            return false;
+        }
+
+        bool compileSeed(const std::vector<std::string_view> &words)
+        {
+            std::uint64_t seed{};
+
+            if (words.size() != 2 || !parseNumber(words[1], seed))
+                return fail("seed wants <n>");
+
+            m_builder.setSeed(seed);
+            return true;
+        }
+
+        bool compileBuilding(const std::vector<std::string_view> &words)
+        {
+            ScenarioFormat::Building building{};
+            building.tint = {GRAY.r, GRAY.g, GRAY.b, GRAY.a};
+
+            if ((words.size() != 5 && words.size() != 8 && words.size() != 9) ||
+                !parseFloat(words[1], building.x) || !parseFloat(words[2], building.y) ||
+                !parseFloat(words[3], building.width) || !parseFloat(words[4], building.height))
+                return fail("building wants <x> <y> <width> <height> [<r> <g> <b> [<a>]]");
+
+            for (std::size_t channel{0}; channel + 5 < words.size(); ++channel)
+            {
+                if (!parseColourChannel(words[channel + 5], building.tint[channel]))
+                    return fail("colour channels go from 0 to 255");
+            }
+
+            if (building.width <= 0.0f || building.height <= 0.0f)
+                return fail("a building needs a positive width and height");
+
+            if (std::abs(building.y + building.height - m_worldHeight) > ScenarioFormat::fitTolerance)
+                return fail("a building has to stand on the ground, its y + height is the height of the world");
+
+            if (building.x < -ScenarioFormat::fitTolerance || building.x + building.width > m_worldWidth + ScenarioFormat::fitTolerance)
+                return fail("a building has to be inside the world, from x 0 to its width");
+
+            m_builder.addBuilding(building);
+            ++m_buildings;
+
+            return true;
+        }
+
+        bool compileLaunchSite(const std::vector<std::string_view> &words)
+        {
+            ScenarioFormat::LaunchSite launchSite{};
+
+            if ((words.size() != 3 && words.size() != 4) ||
+                !parseFloat(words[1], launchSite.minX) || !parseFloat(words[2], launchSite.maxX) ||
+                (words.size() == 4 && !parseFloat(words[3], launchSite.y)))
+                return fail("launch wants <minX> <maxX> [<y>]");
+
+            if (launchSite.minX > launchSite.maxX)
+                return fail("a launch site's minX can't be past its maxX");
+
+            m_builder.addLaunchSite(launchSite);
+            ++m_launchSites;
+
+            return true;
+        }
+
+        bool compileWave(const std::vector<std::string_view> &words)
+        {
+            ScenarioFormat::Wave wave{};
+            wave.perLaunch = 1;
+
+            // clear can only be the last word
+            std::size_t numbers{words.size()};
+
+            if (words.back() == "clear")
+            {
+                wave.flags |= ScenarioFormat::waitForClearSky;
+                --numbers;
+            }
+
+            if ((numbers != 4 && numbers != 5) ||
+                !parseFloat(words[1], wave.delaySeconds) || !parseNumber(words[2], wave.count) ||
+                !parseFloat(words[3], wave.spacingSeconds) ||
+                (numbers == 5 && !parseNumber(words[4], wave.perLaunch)))
+                return fail("wave wants <delaySeconds> <count> <spacingSeconds> [<perLaunch>] [clear]");
+
+            if (wave.delaySeconds < 0.0f || wave.spacingSeconds < 0.0f)
+                return fail("a wave can't wait a negative time");
+
+            if (wave.delaySeconds > ScenarioFormat::maxWaveSeconds || wave.spacingSeconds > ScenarioFormat::maxWaveSeconds)
+                return fail("a wave can't wait more than an hour");
+
+            if (wave.count > ScenarioFormat::maxWaveCount)
+                return fail("a wave sends at most " + std::to_string(ScenarioFormat::maxWaveCount) + " missiles");
+
+            if (wave.perLaunch == 0)
+                return fail("a wave launches at least one missile at a time");
+
+            m_builder.addWave(wave);
+            ++m_waves;
+
+            return true;
+        }
+
+        std::string m_path{};
+        std::size_t m_line{0};
+
+        float m_worldWidth{};
+        float m_worldHeight{};
+
+        ScenarioBuilder m_builder{};
+
+        std::size_t m_buildings{0};
+        std::size_t m_launchSites{0};
+        std::size_t m_waves{0};
+    };
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "usage: scenario_compiler <source.txt> <scenario.mcs>\n";
+        return 2;
+    }
+
+    const std::string sourcePath{argv[1]};
+    const std::string outPath{argv[2]};
+
+    std::ifstream source{sourcePath};
+
+    if (!source)
+    {
+        std::cerr << "can't open " << sourcePath << '\n';
+        return 1;
+    }
+
+    // the world the game plays scenarios in
+    const WorldConfig world{};
+
+    Compiler compiler{sourcePath, world.width, world.height};
+    bool compiled{true};
+
+    // every error of the file, not just the first one
+    for (std::string line{}; std::getline(source, line);)
+        compiled = compiler.compileLine(line) && compiled;
+
+    if (!compiled)
+        return 1;
+
+    // the sections are counted in 32 bits
+    constexpr std::size_t maxCount{std::numeric_limits<std::uint32_t>::max()};
+
+    if (compiler.getBuildings() > maxCount || compiler.getLaunchSites() > maxCount || compiler.getWaves() > maxCount)
+    {
+        std::cerr << sourcePath << ": more than " << maxCount << " of one kind\n";
+        return 1;
+    }
+
+    std::vector<std::uint8_t> bytes{};
+    compiler.getBuilder().write(bytes);
+
+    // whatever is written has to load
+    if (!ScenarioView{bytes, world.width, world.height}.isValid())
+    {
+        std::cerr << sourcePath << " compiled into a scenario that doesn't load\n";
+        return 1;
+    }
+
+    std::ofstream out{outPath, std::ios::binary};
+    out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+    if (!out)
+    {
+        std::cerr << "can't write " << outPath << '\n';
+        return 1;
+    }
+
+    std::cerr << outPath << ": " << compiler.getBuildings() << " buildings, " << compiler.getLaunchSites()
+              << " launch sites, " << compiler.getWaves() << " waves, " << bytes.size() << " bytes\n";
+
+    return 0;
+}